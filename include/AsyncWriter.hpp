@@ -0,0 +1,90 @@
+///
+/// @file AsyncWriter.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with AsyncWriter class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_ASYNCWRITER_HPP
+#define SEDAMAN_ASYNCWRITER_HPP
+
+#include "OSEGD.hpp"
+#include "OSEGY.hpp"
+#include <memory>
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Writes traces in background thread.
+/// write_trace only puts trace to bounded queue, dedicated thread encodes
+/// traces and writes them to file, so caller does not wait for disk.
+/// SEGY traces accumulated in queue are written as one batch.
+/// If writing fails the rest of traces is dropped and the error is
+/// rethrown by every later call of write_trace, flush or close.
+/// \class AsyncWriter
+///
+///
+class AsyncWriter {
+public:
+    ///
+    /// \brief Construct a new AsyncWriter object for SEGY
+    ///
+    /// \param writer Writer to use, it is destroyed on close.
+    /// \param queue_size Maximal number of traces waiting to be written.
+    /// The same number of traces could be in batch being written, so up to
+    /// twice as many traces are held in memory.
+    ///
+    AsyncWriter(std::unique_ptr<OSEGY> writer, size_t queue_size = 256);
+    ///
+    /// \brief Construct a new AsyncWriter object for SEGD
+    ///
+    /// \param writer Writer to use, it is destroyed on close.
+    /// \param queue_size Maximal number of traces waiting to be written.
+    /// The same number of traces could be in batch being written, so up to
+    /// twice as many traces are held in memory.
+    ///
+    AsyncWriter(std::unique_ptr<OSEGD> writer, size_t queue_size = 256);
+    ///
+    /// \brief puts trace to queue
+    /// Waits if queue is full.
+    ///
+    /// \param tr Trace to write.
+    ///
+    /// \throws sedaman::Exception if writer is closed
+    /// \throws any error of previous writes
+    ///
+    void write_trace(Trace tr);
+    ///
+    /// \brief waits until all queued traces are written and passed to
+    /// operating system
+    ///
+    /// \throws sedaman::Exception if writer is closed
+    /// \throws any error of previous writes
+    ///
+    void flush();
+    ///
+    /// \brief writes queued traces, stops thread and destroys writer
+    /// Destruction of writer completes file, e.g. writes trailer stanzas.
+    ///
+    /// \throws any error of previous writes
+    ///
+    void close();
+    ///
+    /// \brief Closes writer, errors are lost, call close to get them.
+    ///
+    ~AsyncWriter();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_ASYNCWRITER_HPP
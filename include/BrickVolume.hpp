@@ -0,0 +1,130 @@
+///
+/// @file BrickVolume.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with BrickVolume class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_BRICKVOLUME_HPP
+#define SEDAMAN_BRICKVOLUME_HPP
+
+#include "CommonSEGY.hpp"
+#include "ISEGY3D.hpp"
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Class for reading sedaman native brick volume files.
+/// Post stack volume is stored in fixed size bricks of
+/// inline x crossline x sample. Every brick is compressed separately without
+/// losses, samples are kept in data sample format of original SEGY. So any
+/// section or slice needs only bricks it crosses.
+/// Trace headers, text headers and binary header are kept too, so volume
+/// could be converted back to SEGY.
+/// \class BrickVolume
+///
+///
+class BrickVolume {
+public:
+    ///
+    /// \brief Converts post stack SEGY to brick volume.
+    ///
+    /// \param segy_name Name of SEGY file to read from.
+    /// \param file_name Name of brick volume file to write to.
+    /// \param brick_il Brick size along inlines.
+    /// \param brick_xl Brick size along crosslines.
+    /// \param brick_smp Brick size along samples.
+    /// \param level Compression level from 1 to 9.
+    /// \param il_name Name of trace header value with inline number.
+    /// \param xl_name Name of trace header value with crossline number.
+    /// \param threads Number of threads, 0 means hardware concurrency.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    static void from_segy(std::string segy_name, std::string file_name,
+                          uint32_t brick_il = 64, uint32_t brick_xl = 64,
+                          uint32_t brick_smp = 64, int level = 6,
+                          std::string il_name = "INLINE",
+                          std::string xl_name = "XLINE",
+                          unsigned threads = 0);
+    ///
+    /// \brief Construct a new BrickVolume object
+    ///
+    /// \param file_name Name of brick volume file.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    BrickVolume(std::string file_name);
+    ///
+    /// \brief grid getter
+    ///
+    /// \return ISEGY3D::Grid const&
+    ///
+    ISEGY3D::Grid const& grid();
+    ///
+    /// \brief number of samples in every trace of volume
+    ///
+    /// \return uint32_t
+    ///
+    uint32_t samples_per_trace();
+    ///
+    /// \brief binary header of original SEGY
+    ///
+    /// \return CommonSEGY::BinaryHeader const&
+    ///
+    CommonSEGY::BinaryHeader const& binary_header();
+    ///
+    /// \brief reads samples of all traces of inline
+    /// Missing traces are filled with zeros.
+    ///
+    /// \param il inline number
+    /// \return std::vector<double> [crossline][sample]
+    ///
+    std::vector<double> inline_section(int64_t il);
+    ///
+    /// \brief reads samples of all traces of crossline
+    /// Missing traces are filled with zeros.
+    ///
+    /// \param xl crossline number
+    /// \return std::vector<double> [inline][sample]
+    ///
+    std::vector<double> crossline_section(int64_t xl);
+    ///
+    /// \brief reads one sample from every trace
+    /// Missing traces are filled with zeros.
+    ///
+    /// \param sample number of sample starting from 0
+    /// \return std::vector<double> [inline][crossline]
+    ///
+    std::vector<double> time_slice(uint32_t sample);
+    ///
+    /// \brief Converts volume back to SEGY.
+    /// SEGY revision is taken from original binary header. Traces are
+    /// written in inline, crossline order. Stored trace headers and samples
+    /// are written without decoding, so traces of SEGY sorted the same way
+    /// are restored byte for byte.
+    ///
+    /// \param segy_name Name of SEGY file to write to.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    void to_segy(std::string segy_name);
+    ~BrickVolume();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_BRICKVOLUME_HPP
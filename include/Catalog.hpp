@@ -0,0 +1,110 @@
+///
+/// @file Catalog.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with Catalog class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_CATALOG_HPP
+#define SEDAMAN_CATALOG_HPP
+
+#include "CommonSEGD.hpp"
+#include "CommonSEGY.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Cheap metadata probes for SEGY and SEGD files.
+/// Only headers at the start of file are read, traces are never walked
+/// through, so time of probe does not depend on file size.
+/// \class Catalog
+///
+///
+class Catalog {
+public:
+    enum class Format { SEGY, SEGD };
+    ///
+    /// \brief Metadata of one file.
+    /// \class Entry
+    ///
+    ///
+    class Entry {
+    public:
+        std::string file_name;
+        Format format;
+        uint64_t file_size;
+        ///
+        /// \brief Binary header for SEGY files.
+        ///
+        std::optional<CommonSEGY::BinaryHeader> binary_header;
+        ///
+        /// \brief General header for SEGD files.
+        ///
+        std::optional<CommonSEGD::GeneralHeader> general_header;
+        ///
+        /// \brief Samples per trace from binary header for SEGY.
+        ///
+        uint32_t samples_per_trace;
+        ///
+        /// \brief Number of traces for SEGY, number of channels in first
+        /// record for SEGD. Empty if it could not be derived without
+        /// walking through traces.
+        ///
+        std::optional<uint64_t> traces_count;
+        ///
+        /// \brief Error message if file could not be probed.
+        ///
+        std::string error;
+    };
+    ///
+    /// \brief reads SEGY text and binary headers and derives number of
+    /// traces from file size when traces have fixed length.
+    /// Headers of gzip compressed file are read through ZStreambuf, number
+    /// of its traces is known only from binary header.
+    ///
+    /// \param file_name Name of SEGY file.
+    /// \return Entry
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    static Entry probe_segy(std::string file_name);
+    ///
+    /// \brief reads SEGD headers before first trace
+    ///
+    /// \param file_name Name of SEGD file.
+    /// \return Entry
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    static Entry probe_segd(std::string file_name);
+    ///
+    /// \brief probes all SEGY and SEGD files in directory tree concurrently
+    /// Files are recognized by extension: .sgy, .segy, .sgy.gz and .segy.gz
+    /// for SEGY, .sgd and .segd for SEGD, case is ignored. Files which could not be probed are
+    /// returned with error message instead of throwing.
+    ///
+    /// \param dir_name Name of directory.
+    /// \param threads Number of threads, 0 means hardware concurrency.
+    /// \return std::vector<Entry> sorted by file name
+    ///
+    /// \throws std::filesystem::filesystem_error If directory could not be
+    /// walked through
+    ///
+    static std::vector<Entry> scan(std::string const& dir_name,
+                                   unsigned threads = 0);
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_CATALOG_HPP
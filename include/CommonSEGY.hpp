@@ -152,6 +152,77 @@ public:
     ///
     static void ascii_to_ebcdic(std::string& ascii);
     ///
+    /// \brief Returns number of bytes per sample for data sample format code.
+    /// 
+    /// \param format_code Data sample format code from binary header.
+    /// \return int 
+    ///
+    /// \throws sedaman::Exception
+    ///
+    static int format_bytes(int16_t format_code);
+    ///
+    /// \brief Reads trace header value from raw bytes.
+    /// 
+    /// \param buf Pointer to value in raw trace header.
+    /// \param type Type of value.
+    /// \param endianness Endianness field from binary header.
+    /// \return Trace::Header::Value 
+    ///
+    static Trace::Header::Value read_header_value(char const* buf,
+        Trace::Header::ValueType type, int32_t endianness);
+    ///
+    /// \brief Writes trace header value to raw bytes.
+    /// Counterpart of read_header_value.
+    /// 
+    /// \param buf Pointer to value in raw trace header.
+    /// \param type Type of value.
+    /// \param v Value to write, converted to type.
+    /// \param endianness Endianness field from binary header.
+    ///
+    /// \throws sedaman::Exception
+    ///
+    static void write_header_value(char* buf, Trace::Header::ValueType type,
+        Trace::Header::Value const& v, int32_t endianness);
+    ///
+    /// \brief Decodes raw trace samples.
+    /// Format is dispatched once per call, so the loop over samples does not
+    /// go through function objects. Instantiated for float and double.
+    /// 
+    /// @tparam T float or double
+    /// \param buf Raw samples.
+    /// \param out Destination for n decoded samples.
+    /// \param n Number of samples.
+    /// \param format_code Data sample format code from binary header.
+    /// \param endianness Endianness field from binary header.
+    ///
+    /// \throws sedaman::Exception
+    ///
+    template <typename T>
+    static void read_samples(char const* buf, T* out, std::size_t n,
+        int16_t format_code, int32_t endianness);
+    ///
+    /// \brief Decodes raw binary header.
+    /// Byte order is taken from endianness field of header. Fields
+    /// introduced in revision 2 are filled only for revision 2 and later.
+    /// 
+    /// \param buf Raw binary header of BIN_HEADER_SIZE bytes.
+    /// \return BinaryHeader 
+    ///
+    /// \throws sedaman::Exception
+    ///
+    static BinaryHeader parse_binary_header(char const* buf);
+    ///
+    /// \brief Encodes binary header to raw bytes.
+    /// Counterpart of parse_binary_header, only fields read by it are
+    /// written, so unassigned bytes of buf are kept.
+    /// 
+    /// \param bh Binary header to encode.
+    /// \param buf Raw binary header of BIN_HEADER_SIZE bytes.
+    ///
+    /// \throws sedaman::Exception
+    ///
+    static void format_binary_header(BinaryHeader const& bh, char* buf);
+    ///
     /// \brief Default SEGY text header from standard.
     ///
     static char const* default_text_header;
@@ -177,6 +248,13 @@ public:
     /// 
     static constexpr int TR_HEADER_SIZE = 240;
     ///
+    /// \brief Value of endianness field for file in host byte order
+    /// Revision 2 files with it are written and read without byte swapping,
+    /// on x86 it gives little-endian file.
+    ///
+    /// 
+    static constexpr int32_t NATIVE_ENDIANNESS = 0x01020304;
+    ///
     /// \brief Can be used to browse headers or get there description.
     ///
     /// 
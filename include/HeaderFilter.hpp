@@ -0,0 +1,71 @@
+///
+/// @file HeaderFilter.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with HeaderFilter class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_HEADERFILTER_HPP
+#define SEDAMAN_HEADERFILTER_HPP
+
+#include "ISEGY.hpp"
+#include <string>
+#include <vector>
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Predicate on trace header values.
+/// Expression is compiled against trace header map of file, so only bytes of
+/// referenced values are read from raw trace headers on evaluation.
+/// Expression syntax is C like: names of trace header values, numbers,
+/// parentheses, arithmetic + - * / %, comparisons == != < <= > >= and
+/// logical ! && ||. All arithmetic is done in double precision, % is
+/// floating point remainder. Non zero result means trace matches.
+/// Example: OFFSET > 1000 && CHAN % 2 == 0 && TRACE_ID == 1
+/// \class HeaderFilter
+///
+///
+class HeaderFilter {
+public:
+    ///
+    /// \brief Compiles expression.
+    ///
+    /// \param expression Filter expression.
+    /// \param segy File to take trace header map and byte order from.
+    ///
+    /// \throws sedaman::Exception on syntax error or unknown header name
+    ///
+    HeaderFilter(std::string const& expression, ISEGY& segy);
+    HeaderFilter(HeaderFilter const& f);
+    HeaderFilter(HeaderFilter&& f) noexcept;
+    ///
+    /// \brief evaluates expression
+    /// Could be called concurrently.
+    ///
+    /// \param raw_hdrs Raw trace headers of ISEGY::raw_headers_size() bytes.
+    /// \return true if trace matches
+    ///
+    bool matches(char const* raw_hdrs) const;
+    ///
+    /// \brief names of trace header values used in expression
+    ///
+    /// \return std::vector<std::string> const&
+    ///
+    std::vector<std::string> const& names() const;
+    ~HeaderFilter();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_HEADERFILTER_HPP
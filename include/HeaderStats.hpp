@@ -0,0 +1,95 @@
+///
+/// @file HeaderStats.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with HeaderStats class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_HEADERSTATS_HPP
+#define SEDAMAN_HEADERSTATS_HPP
+
+#include "CommonSEGY.hpp"
+#include <string>
+#include <vector>
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Statistics of trace header values.
+/// All values of all traces are walked through in one multithreaded pass
+/// over raw trace headers, Trace::Header objects are not created.
+/// Results are cached in memory by file path, size and modification time,
+/// so repeated calls for unchanged file are free.
+/// \class HeaderStats
+///
+///
+class HeaderStats {
+public:
+    ///
+    /// \brief Statistics of one trace header value.
+    /// \class Field
+    ///
+    ///
+    class Field {
+    public:
+        std::string name;
+        ///
+        /// \brief Number of traces.
+        ///
+        uint64_t count;
+        ///
+        /// \brief Number of traces where value is not zero.
+        ///
+        uint64_t nonzero;
+        ///
+        /// \brief Minimum, maximum and mean of finite values.
+        ///
+        double min;
+        double max;
+        double mean;
+        ///
+        /// \brief Estimated number of distinct values, error is about 3%.
+        ///
+        uint64_t distinct;
+        ///
+        /// \brief Histogram with bins of bin_width starting at bin_start.
+        /// Bin width is power of two chosen so that number of bins does
+        /// not exceed requested one.
+        ///
+        double bin_start;
+        double bin_width;
+        std::vector<uint64_t> histogram;
+    };
+    ///
+    /// \brief computes statistics for every value in trace header map
+    ///
+    /// \param file_name Name of SEGY file.
+    /// \param tr_hdr_map Trace header map, values of headers absent in file
+    /// are skipped.
+    /// \param bins Maximum number of histogram bins.
+    /// \param threads Number of threads, 0 means hardware concurrency.
+    /// \return std::vector<Field> in order of trace header map
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    static std::vector<Field> compute(std::string file_name,
+        std::vector<std::pair<std::string, std::map<uint32_t,
+        std::pair<std::string, Trace::Header::ValueType>>>> tr_hdr_map =
+        CommonSEGY::default_trace_header, unsigned bins = 64,
+        unsigned threads = 0);
+    ///
+    /// \brief drops all cached results
+    ///
+    static void clear_cache();
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_HEADERSTATS_HPP
@@ -257,6 +257,56 @@ public:
     /// \return Trace 
     ///
     Trace read_trace();
+    ///
+    /// \brief All traces of one record.
+    /// \class Record
+    ///
+    ///
+    class Record {
+    public:
+        ///
+        /// \brief Traces of one channel set.
+        /// \class ChannelSet
+        ///
+        ///
+        class ChannelSet {
+        public:
+            CommonSEGD::ChannelSetHeader header;
+            uint32_t samp_num;
+            ///
+            /// \brief Samples in [channel][sample] order.
+            /// Channels go in order of reading, descale multiplier is
+            /// applied.
+            ///
+            std::vector<double> samples;
+            ///
+            /// \brief Ordinal number of trace in record for every channel.
+            /// It is row of header values.
+            ///
+            std::vector<uint64_t> traces;
+        };
+        std::vector<ChannelSet> channel_sets;
+        ///
+        /// \brief Trace header values by name, one for every trace in
+        /// order of reading.
+        /// Value missing in some trace headers is 0 for them.
+        ///
+        std::unordered_map<std::string, std::vector<Trace::Header::Value>>
+            headers;
+    };
+    ///
+    /// \brief Reads all traces of current record
+    /// If some traces of record are already read by read_trace, the rest
+    /// is read. Samples of every channel set go to one matrix and trace
+    /// headers to one table, so there are no allocations for every trace.
+    /// 
+    /// \return Record 
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception if there is no record to read or traces
+    /// of channel set have different number of samples
+    ///
+    Record read_record();
     ~ISEGD();
 
 private:
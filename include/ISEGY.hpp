@@ -14,6 +14,10 @@
 
 #include "CommonSEGY.hpp"
 #include "Trace.hpp"
+#include <functional>
+#include <istream>
+#include <memory>
+#include <optional>
 
 ///
 /// \brief General namespace for sedaman library.
@@ -29,8 +33,30 @@ namespace sedaman {
 /// 
 class ISEGY {
 public:
+    ///
+    /// \brief Headers and trace positions found on opening of file.
+    /// Could be passed to constructor to open the same file again without
+    /// reading its headers and walking through its traces.
+    /// \class Layout
+    ///
+    ///
+    class Layout {
+    public:
+        std::vector<std::string> text_headers;
+        CommonSEGY::BinaryHeader binary_header;
+        std::vector<std::string> trailer_stanzas;
+        std::streampos first_trace;
+        std::streampos end_of_data;
+        ///
+        /// \brief Positions of traces, empty for fixed trace length.
+        ///
+        std::vector<std::streampos> traces;
+    };
     ///
     /// \brief Construct a new ISEGY object
+    /// File compressed with gzip is decompressed on the fly, see
+    /// ZStreambuf. Index written by ZStreambuf::write_index makes random
+    /// access and opening of such file cheap.
     /// 
     /// \param file_name Name of SEGY file.
     /// \param tr_hdr_over Could be used to override trace header schema from
@@ -62,8 +88,25 @@ public:
 	   	std::pair<std::string, Trace::Header::ValueType>>>> hdr_map =
 	   	CommonSEGY::default_trace_header);
     ///
-    /// \brief creates ISEGY instance internally and returns binary header.
+    /// \brief Construct a new ISEGY object without reading headers
+    /// Layout must be taken from the same unchanged file.
+    ///
+    /// \param file_name Name of SEGY file.
+    /// \param layout Layout returned by layout() of other object.
+    /// \param hdr_map Could be used to override trace header schema from
+    /// standard
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    ISEGY(std::string file_name, Layout layout,
+        std::vector<std::pair<std::string, std::map<uint32_t,
+        std::pair<std::string, Trace::Header::ValueType>>>> hdr_map =
+        CommonSEGY::default_trace_header);
+    ///
+    /// \brief reads only binary header from file.
     /// Could be used to get binary header from file to override some values.
+    /// Traces and trailer stanzas are not touched.
     /// 
     /// \param file_name Name of SEGY file.
     /// \return CommonSEGY::BinaryHeader 
@@ -80,6 +123,9 @@ public:
     std::vector<std::string> const& text_headers();
     ///
     /// \brief segy trailer stanzas getter
+    /// For variable trace length files with unknown number of trailer stanzas
+    /// they are found only on first call, which walks through trace headers.
+    /// Constructor does not do it, so opening such file is cheap.
     /// 
     /// \return std::vector<std::string> const& 
     ///
@@ -109,6 +155,111 @@ public:
     /// \return Trace 
     ///
     virtual Trace read_trace();
+    ///
+    /// \brief reads next trace without decoding of samples
+    /// Samples keep format and byte order of file, see
+    /// OSEGY::write_raw_trace.
+    /// 
+    /// \param samples Raw samples of trace are put here.
+    /// \return Trace::Header
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    ///
+    Trace::Header read_raw_trace(std::vector<char>& samples);
+    ///
+    /// \brief returns number of traces in file
+    /// For files with variable trace length all trace headers are walked
+    /// through on first call to build trace index.
+    /// 
+    /// \return uint64_t 
+    ///
+    uint64_t traces_count();
+    ///
+    /// \brief headers and trace positions of file
+    /// For files with variable trace length all trace headers are walked
+    /// through on first call to build trace index.
+    ///
+    /// \return Layout
+    ///
+    Layout layout();
+    ///
+    /// \brief returns position of trace in file
+    /// 
+    /// \param num ordinal number of trace starting from 0
+    /// \return std::streampos 
+    ///
+    /// \throws sedaman::Exception if there is no such trace
+    ///
+    std::streampos trace_position(uint64_t num);
+    ///
+    /// \brief moves to trace with given number
+    /// Next call to read_header or read_trace reads this trace.
+    /// 
+    /// \param num ordinal number of trace starting from 0
+    ///
+    /// \throws sedaman::Exception if there is no such trace
+    ///
+    void seek_trace(uint64_t num);
+    ///
+    /// \brief writes new file with given traces of this file
+    /// Text headers, binary header and trailer stanzas are copied, for
+    /// revision 2 number of traces in binary header is set. Traces are
+    /// copied as they are, ranges of consecutive traces are copied at once.
+    /// On Linux copying is done by kernel with copy_file_range, so it goes
+    /// at storage speed and does not take CPU. Current position in file is
+    /// not changed.
+    /// 
+    /// \param file_name Name of new file.
+    /// \param traces Ordinal numbers of traces in order to write them.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception if there is no such trace
+    ///
+    void extract_traces(std::string const& file_name,
+                        std::vector<uint64_t> const& traces);
+    ///
+    /// \brief size of trace headers in bytes
+    /// Main trace header followed by additional trace headers.
+    /// 
+    /// \return uint32_t 
+    ///
+    uint32_t raw_headers_size();
+    ///
+    /// \brief looks for trace header value in raw trace headers
+    /// If name is used in several headers the last one is taken, as it
+    /// overrides previous ones on reading.
+    /// 
+    /// \param name Name of trace header value.
+    /// \return std::optional<std::pair<uint32_t, Trace::Header::ValueType>>
+    /// offset from start of raw trace headers and type of value
+    ///
+    std::optional<std::pair<uint32_t, Trace::Header::ValueType>>
+    raw_header_offset(std::string const& name);
+    ///
+    /// \brief reads raw trace headers skipping samples
+    /// Traces are split into contiguous ranges and every range is read by
+    /// its own thread with its own file stream, so func could be called
+    /// concurrently for different traces. Current position in file is not
+    /// changed.
+    /// 
+    /// \param func Called with thread number, ordinal number of trace and
+    /// raw trace headers of raw_headers_size() bytes.
+    /// \param threads Number of threads, 0 means hardware concurrency.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    ///
+    void read_raw_headers(std::function<void(unsigned, uint64_t,
+        char const*)> func, unsigned threads = 0);
+    ///
+    /// \brief opens new stream over file independent from this object
+    /// Compressed file is decompressed, seek points are shared.
+    /// 
+    /// \param buffered Could be false for sparse reads of plain file.
+    /// \return std::unique_ptr<std::istream>
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    ///
+    std::unique_ptr<std::istream> open_stream(bool buffered = true);
     virtual ~ISEGY();
 
 protected:
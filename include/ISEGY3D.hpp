@@ -0,0 +1,191 @@
+///
+/// @file ISEGY3D.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with ISEGY3D class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_ISEGY3D_HPP
+#define SEDAMAN_ISEGY3D_HPP
+
+#include "CommonSEGY.hpp"
+#include "ISEGY.hpp"
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Class for post stack 3D SEGY reading.
+/// Inline/crossline grid is inferred from trace headers on construction.
+/// Sections and time slices are read with positional reads of needed
+/// samples only, concurrently by several threads.
+/// \class ISEGY3D
+///
+///
+class ISEGY3D : public ISEGY {
+public:
+    ///
+    /// \brief Inline/crossline grid of volume.
+    /// \class Grid
+    ///
+    ///
+    class Grid {
+    public:
+        int64_t il_first;
+        int64_t il_step;
+        uint64_t il_num;
+        int64_t xl_first;
+        int64_t xl_step;
+        uint64_t xl_num;
+        ///
+        /// \brief Number of grid nodes without traces.
+        ///
+        uint64_t missing;
+    };
+    ///
+    /// \brief Whole volume loaded into memory.
+    /// \class Cube
+    ///
+    ///
+    class Cube {
+    public:
+        Grid grid;
+        uint32_t samp_num;
+        ///
+        /// \brief Samples in [inline][crossline][sample] order.
+        /// Samples of missing and dead traces are zeros.
+        ///
+        std::vector<float> samples;
+        ///
+        /// \brief Live trace flags in [inline][crossline] order.
+        /// Zero for missing traces and for dead ones (TRACE_ID equal to 2).
+        ///
+        std::vector<uint8_t> mask;
+    };
+    ///
+    /// \brief Construct a new ISEGY3D object
+    ///
+    /// \param file_name Name of SEGY file.
+    /// \param il_name Name of trace header value with inline number.
+    /// \param xl_name Name of trace header value with crossline number.
+    /// \param hdr_map Could be used to override trace header schema from
+    /// standard
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    ISEGY3D(std::string file_name, std::string il_name = "INLINE",
+            std::string xl_name = "XLINE",
+            std::vector<std::pair<std::string,
+            std::map<uint32_t, std::pair<std::string,
+            Trace::Header::ValueType>>>>
+                hdr_map = CommonSEGY::default_trace_header);
+    ///
+    /// \brief Construct a new ISEGY3D object
+    ///
+    /// \param file_name Name of SEGY file.
+    /// \param binary_header Could be used to override values in binary header.
+    /// \param il_name Name of trace header value with inline number.
+    /// \param xl_name Name of trace header value with crossline number.
+    /// \param hdr_map Could be used to override trace header schema from
+    /// standard
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    ISEGY3D(std::string file_name, CommonSEGY::BinaryHeader binary_header,
+            std::string il_name = "INLINE", std::string xl_name = "XLINE",
+            std::vector<std::pair<std::string,
+            std::map<uint32_t, std::pair<std::string,
+            Trace::Header::ValueType>>>>
+                hdr_map = CommonSEGY::default_trace_header);
+    ///
+    /// \brief grid getter
+    ///
+    /// \return Grid const&
+    ///
+    Grid const& grid();
+    ///
+    /// \brief number of samples in every trace of volume
+    ///
+    /// \return uint32_t
+    ///
+    uint32_t samples_per_trace();
+    ///
+    /// \brief checks if there is a trace at grid node
+    ///
+    /// \param il inline number
+    /// \param xl crossline number
+    /// \return true
+    /// \return false
+    ///
+    bool trace_exists(int64_t il, int64_t xl);
+    ///
+    /// \brief ordinal number of trace at grid node
+    ///
+    /// \param il inline number
+    /// \param xl crossline number
+    /// \return std::optional<uint64_t> empty for missing trace
+    ///
+    std::optional<uint64_t> trace_number(int64_t il, int64_t xl);
+    ///
+    /// \brief reads trace at grid node
+    ///
+    /// \param il inline number
+    /// \param xl crossline number
+    /// \return Trace
+    ///
+    /// \throws sedaman::Exception if there is no trace
+    ///
+    Trace get_trace(int64_t il, int64_t xl);
+    ///
+    /// \brief reads samples of all traces of inline
+    /// Missing traces are filled with zeros.
+    ///
+    /// \param il inline number
+    /// \return std::vector<double> [crossline][sample]
+    ///
+    std::vector<double> inline_section(int64_t il);
+    ///
+    /// \brief reads samples of all traces of crossline
+    /// Missing traces are filled with zeros.
+    ///
+    /// \param xl crossline number
+    /// \return std::vector<double> [inline][sample]
+    ///
+    std::vector<double> crossline_section(int64_t xl);
+    ///
+    /// \brief reads one sample from every trace
+    /// Missing traces are filled with zeros.
+    ///
+    /// \param sample number of sample starting from 0
+    /// \return std::vector<double> [inline][crossline]
+    ///
+    std::vector<double> time_slice(uint32_t sample);
+    ///
+    /// \brief loads whole volume into memory
+    /// Traces are split into ranges in file order, which are read by
+    /// separate threads with big reads. Samples are decoded directly into
+    /// the cube.
+    ///
+    /// \param threads Number of threads, 0 means hardware concurrency.
+    /// \return Cube
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    ///
+    Cube read_cube(unsigned threads = 0);
+    virtual ~ISEGY3D();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_ISEGY3D_HPP
@@ -0,0 +1,138 @@
+///
+/// @file ISEGYDataset.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with ISEGYDataset class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_ISEGYDATASET_HPP
+#define SEDAMAN_ISEGYDATASET_HPP
+
+#include "CommonSEGY.hpp"
+#include "ISEGY.hpp"
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Class for reading several SEGY files as one sequence of traces.
+/// Files are opened in parallel on construction to get binary headers and
+/// numbers of traces, after that traces are addressed by global ordinal
+/// number. Headers and trace positions of every file are kept, so files
+/// are opened again without reading their headers or walking through their
+/// traces. Only a few recently read files are kept open, so number of files
+/// is not limited by number of file descriptors.
+/// \class ISEGYDataset
+///
+///
+class ISEGYDataset {
+public:
+    ///
+    /// \brief Construct a new ISEGYDataset object
+    ///
+    /// \param file_names Names of SEGY files in order of traces.
+    /// \param hdr_map Could be used to override trace header schema from
+    /// standard
+    /// \param threads Number of threads, 0 means hardware concurrency.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    ISEGYDataset(std::vector<std::string> file_names,
+        std::vector<std::pair<std::string, std::map<uint32_t,
+        std::pair<std::string, Trace::Header::ValueType>>>> hdr_map =
+        CommonSEGY::default_trace_header, unsigned threads = 0);
+    ///
+    /// \brief number of files in dataset
+    ///
+    /// \return uint64_t
+    ///
+    uint64_t files_count();
+    ///
+    /// \brief name of file
+    ///
+    /// \param file number of file starting from 0
+    /// \return std::string const&
+    ///
+    std::string const& file_name(uint64_t file);
+    ///
+    /// \brief binary header of file
+    ///
+    /// \param file number of file starting from 0
+    /// \return CommonSEGY::BinaryHeader const&
+    ///
+    CommonSEGY::BinaryHeader const& binary_header(uint64_t file);
+    ///
+    /// \brief total number of traces in all files
+    ///
+    /// \return uint64_t
+    ///
+    uint64_t traces_count();
+    ///
+    /// \brief finds file with trace
+    ///
+    /// \param num global ordinal number of trace starting from 0
+    /// \return std::pair<uint64_t, uint64_t> number of file and ordinal
+    /// number of trace in that file
+    ///
+    /// \throws sedaman::Exception if there is no such trace
+    ///
+    std::pair<uint64_t, uint64_t> locate(uint64_t num);
+    ///
+    /// \brief moves to trace with given global number
+    ///
+    /// \param num global ordinal number of trace starting from 0
+    ///
+    /// \throws sedaman::Exception if there is no such trace
+    ///
+    void seek_trace(uint64_t num);
+    ///
+    /// \brief checks for next trace in dataset
+    ///
+    /// \return true
+    /// \return false
+    ///
+    bool has_trace();
+    ///
+    /// \brief reads header, skips samples
+    ///
+    /// \return Trace::Header
+    ///
+    Trace::Header read_header();
+    ///
+    /// \brief reads one trace
+    ///
+    /// \return Trace
+    ///
+    Trace read_trace();
+    ///
+    /// \brief collects value of trace header for every trace
+    /// Files are processed concurrently, every file by one thread with its
+    /// own file stream. Values are kept, so next call with the same name
+    /// does not read files.
+    ///
+    /// \param name Name of trace header value.
+    /// \param threads Number of threads, 0 means hardware concurrency.
+    /// \return std::vector<Trace::Header::Value> indexed by global ordinal
+    /// number of trace
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception if there is no such header value
+    ///
+    std::vector<Trace::Header::Value> header_values(std::string const& name,
+                                                    unsigned threads = 0);
+    ~ISEGYDataset();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_ISEGYDATASET_HPP
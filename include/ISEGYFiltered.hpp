@@ -0,0 +1,106 @@
+///
+/// @file ISEGYFiltered.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with ISEGYFiltered class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_ISEGYFILTERED_HPP
+#define SEDAMAN_ISEGYFILTERED_HPP
+
+#include "CommonSEGY.hpp"
+#include "HeaderFilter.hpp"
+#include "ISEGY.hpp"
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Class for reading traces matching filter expression.
+/// Matching traces are found on first use by parallel pass over raw trace
+/// headers, samples of other traces are never read.
+/// \class ISEGYFiltered
+///
+///
+class ISEGYFiltered : public ISEGY {
+public:
+    ///
+    /// \brief Construct a new ISEGYFiltered object
+    ///
+    /// \param file_name Name of SEGY file.
+    /// \param expression Filter expression, see HeaderFilter.
+    /// \param hdr_map Could be used to override trace header schema from
+    /// standard
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    ISEGYFiltered(std::string file_name, std::string const& expression,
+        std::vector<std::pair<std::string, std::map<uint32_t,
+        std::pair<std::string, Trace::Header::ValueType>>>> hdr_map =
+        CommonSEGY::default_trace_header);
+    ///
+    /// \brief Construct a new ISEGYFiltered object
+    ///
+    /// \param file_name Name of SEGY file.
+    /// \param expression Filter expression, see HeaderFilter.
+    /// \param binary_header Could be used to override values in binary header.
+    /// \param hdr_map Could be used to override trace header schema from
+    /// standard
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    ISEGYFiltered(std::string file_name, std::string const& expression,
+        CommonSEGY::BinaryHeader binary_header,
+        std::vector<std::pair<std::string, std::map<uint32_t,
+        std::pair<std::string, Trace::Header::ValueType>>>> hdr_map =
+        CommonSEGY::default_trace_header);
+    ///
+    /// \brief checks for next matching trace in file
+    ///
+    /// \return true
+    /// \return false
+    ///
+    virtual bool has_trace() override;
+    ///
+    /// \brief reads header of next matching trace
+    ///
+    /// \return Trace::Header
+    ///
+    virtual Trace::Header read_header() override;
+    ///
+    /// \brief reads next matching trace
+    ///
+    /// \return Trace
+    ///
+    virtual Trace read_trace() override;
+    ///
+    /// \brief ordinal numbers of all matching traces
+    ///
+    /// \param threads Number of threads used on first call, 0 means
+    /// hardware concurrency.
+    /// \return std::vector<uint64_t> const&
+    ///
+    std::vector<uint64_t> const& selected(unsigned threads = 0);
+    ///
+    /// \brief compiled filter
+    ///
+    /// \return HeaderFilter const&
+    ///
+    HeaderFilter const& filter();
+    virtual ~ISEGYFiltered();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_ISEGYFILTERED_HPP
@@ -59,6 +59,12 @@ public:
     /// \param tr Trace to write.
     ///
     virtual void write_trace(Trace& tr) = 0;
+    ///
+    /// \brief passes buffered traces to operating system
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    ///
+    void flush();
     virtual ~OSEGD();
 
 protected:
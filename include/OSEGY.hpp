@@ -14,6 +14,7 @@
 
 #include "CommonSEGY.hpp"
 #include "Trace.hpp"
+#include <span>
 
 ///
 /// \brief General namespace for sedaman library.
@@ -30,6 +31,22 @@ namespace sedaman {
 /// 
 class OSEGY {
 public:
+    ///
+    /// \brief Tag for constructors opening existing file to append traces.
+    ///
+    ///
+    struct Append {
+        explicit Append() = default;
+    };
+    ///
+    /// \brief How samples are scaled for integer formats.
+    ///
+    ///
+    enum class Quantization {
+        none, ///< samples are only cast
+        trace, ///< scale is chosen for every trace
+        file ///< the same scale for all traces of file
+    };
     ///
     /// \brief Construct a new OSEGY object
     /// 
@@ -49,10 +66,133 @@ public:
     /// \param tr Trace to write.
     ///
     virtual void write_trace(Trace& tr) = 0;
+    ///
+    /// \brief Writes traces to the end of file.
+    /// Traces are encoded into one buffer which is written at once, so
+    /// there is one write call for the batch instead of several per trace.
+    /// If some trace could not be encoded nothing from batch is written.
+    /// 
+    /// \param traces Traces to write.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure.
+    /// \throws sedaman::Exception
+    ///
+    void write_traces(std::vector<Trace>& traces);
+    ///
+    /// \brief Writes traces with the same number of samples to the end of
+    /// file.
+    /// Same as above for samples stored in one matrix.
+    /// 
+    /// \param headers Header values for every trace.
+    /// \param samples Samples of all traces [trace][sample].
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure.
+    /// \throws sedaman::Exception
+    ///
+    void write_traces(std::vector<std::unordered_map<std::string,
+                      Trace::Header::Value>> headers,
+                      std::vector<double> const& samples);
+    ///
+    /// \brief Writes trace with samples not decoded from input file.
+    /// If format and byte order of samples match output file, samples are
+    /// copied as they are, otherwise they are converted. Only header goes
+    /// through trace header map. Samples could be read by
+    /// ISEGY::read_raw_trace, format and byte order are in its binary
+    /// header.
+    /// 
+    /// \param hdr Trace header.
+    /// \param samples Raw samples.
+    /// \param format_code Data sample format code of samples.
+    /// \param endianness Endianness field from binary header of samples.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure.
+    /// \throws sedaman::Exception
+    ///
+    void write_raw_trace(Trace::Header hdr, std::vector<char> const& samples,
+                         int16_t format_code, int32_t endianness);
+    ///
+    /// \brief Writes trace with given ordinal number.
+    /// Only for fixed trace length with number of samples from binary
+    /// header. Offset of trace is known from its number, so it is encoded
+    /// in calling thread and written with positional write. Could be called
+    /// concurrently from several threads in any order of numbers, but not
+    /// together with write_trace. Numbers start after traces written so
+    /// far, missing numbers are left filled with zeros. On destruction
+    /// number of traces in binary header is updated for revision 2.
+    /// 
+    /// \param num Ordinal number of trace.
+    /// \param tr Trace to write.
+    ///
+    /// \throws sedaman::Exception
+    ///
+    void write_trace_at(uint64_t num, Trace const& tr);
+    ///
+    /// \brief Preallocates file for traces and writes them to its mapping.
+    /// Only for fixed trace length with number of samples from binary
+    /// header. Space for num traces after everything written so far is
+    /// allocated at once, then traces are encoded right into shared mapping
+    /// of file without stream buffers and write calls. Writing more traces
+    /// doubles allocated space. On destruction file is cut to written size
+    /// and binary header is updated. Could be called again to reserve more.
+    /// On systems without mmap traces are written as usual.
+    /// 
+    /// \param num Number of traces to reserve space for.
+    ///
+    /// \throws sedaman::Exception
+    ///
+    void reserve_traces(uint64_t num);
+    ///
+    /// \brief Sets scaling of samples for formats 3 (int16) and 8 (int8).
+    /// Samples are multiplied by 2^N and rounded, N is the biggest number
+    /// keeping maximal absolute sample in range of format. N is written to
+    /// weight_key of trace header, for standard TRACE_WEIGHT sample value
+    /// is stored integer multiplied by 2^-N. With Quantization::file N is
+    /// chosen by the first trace with nonzero samples, bigger samples of
+    /// later traces are clipped. Raw samples of the same format are not
+    /// scaled.
+    /// 
+    /// \param mode Scaling mode.
+    /// \param weight_key Name of trace header value for N.
+    ///
+    /// \throws sedaman::Exception if format is not 3 or 8 or trace header
+    /// map has no weight_key
+    ///
+    void set_quantization(Quantization mode,
+                          std::string const& weight_key = "TRACE_WEIGHT");
+    ///
+    /// \brief passes buffered traces to operating system
+    /// Traces written to mapping are already there.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    ///
+    void flush();
     virtual ~OSEGY();
 
 protected:
+    ///
+    /// \brief Construct a new OSEGY object over existing file
+    /// Binary header and trailer stanzas are read from file, trailer stanzas
+    /// are cut off and position is set after the last trace. For revision 2
+    /// nonzero number of traces in binary header is increased by number of
+    /// written traces on destruction.
+    ///
+    /// \param file_name Name of file to append to.
+    /// \param tr_hdrs_map Trace header map.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure.
+    /// \throws sedaman::Exception
+    ///
+    OSEGY(std::string file_name, Append,
+        std::vector<std::pair<std::string, std::map<uint32_t,
+        std::pair<std::string, Trace::Header::ValueType>>>> tr_hdrs_map);
     CommonSEGY& common();
+    ///
+    /// \brief position in file where next trace goes
+    /// Differs from file position while batch is encoded.
+    ///
+    /// \return std::streampos
+    ///
+    std::streampos position();
     void assign_raw_writers();
     void assign_sample_writer();
     void assign_bytes_per_sample();
@@ -63,8 +203,76 @@ protected:
     void write_additional_trace_headers(Trace::Header const& hdr);
     void write_trace_samples_fix(Trace const& t);
     void write_trace_samples_var(Trace const& t);
+    ///
+    /// \brief unmaps reserved space and cuts file after the last trace
+    /// File position is set to the end of traces.
+    ///
+    /// \throws sedaman::Exception
+    ///
+    void close_mapping();
+    ///
+    /// \brief chooses scale of trace samples before it is written
+    /// Called by write_trace before trace header is written.
+    ///
+    /// \param tr Trace to write.
+    ///
+    /// \throws sedaman::Exception if samples are infinite or NaN
+    ///
+    void choose_weight(Trace const& tr);
 
 private:
+    friend class BrickVolume;
+    friend class SEGYTee;
+    ///
+    /// \brief sets buffer getting copy of all bytes written to file
+    ///
+    /// \param buf Buffer or nullptr to stop copying.
+    /// \param hdrs Gets offsets of trace headers in buf, could be nullptr.
+    ///
+    void capture_to(std::vector<char>* buf, std::vector<size_t>* hdrs);
+    ///
+    /// \brief sets trace headers encoded by other writer to copy
+    /// Trace headers are not encoded while set, only weight of quantized
+    /// samples is written over them.
+    ///
+    /// \param buf Bytes captured from other writer or nullptr to stop.
+    /// \param offs Offsets of trace headers in buf.
+    ///
+    void share_headers(std::vector<char> const* buf,
+                       std::vector<size_t> const* offs);
+    ///
+    /// \brief writes traces encoded by other writer
+    ///
+    /// \param buf Encoded traces.
+    /// \param traces Number of traces in buf.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure.
+    ///
+    void write_encoded(std::vector<char> const& buf, uint64_t traces);
+    ///
+    /// \brief writes part of traces as one batch, see write_traces
+    ///
+    /// \param traces Traces to write.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure.
+    /// \throws sedaman::Exception
+    ///
+    void write_batch(std::span<Trace> traces);
+    ///
+    /// \brief checks if traces are encoded to the same bytes as by other
+    ///
+    /// \param other Other writer.
+    /// \return true if encoded traces could be shared
+    ///
+    bool same_encoding(OSEGY const& other) const;
+    ///
+    /// \brief checks if trace headers encoded by other could be copied
+    /// Samples could differ in format or quantization.
+    ///
+    /// \param other Other writer.
+    /// \return true if encoded trace headers could be shared
+    ///
+    bool same_headers(OSEGY const& other) const;
     class Impl;
     std::unique_ptr<Impl> pimpl;
 };
@@ -63,6 +63,21 @@ public:
 	  		  std::pair<std::string, Trace::Header::ValueType>>>> tr_hdrs_map =
 			  CommonSEGY::default_trace_header);
     ///
+    /// \brief Opens existing SEGY rev 0 or rev 1 file to append traces.
+    /// Binary header of file is used for writing.
+    /// 
+    /// \param file_name Name of SEGY file.
+    /// \param append Tag to choose this constructor.
+    /// \param tr_hdrs_map Trace header map.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    /// 
+    OSEGYRev1(std::string file_name, Append append,
+			  std::vector<std::pair<std::string, std::map<uint32_t,
+	  		  std::pair<std::string, Trace::Header::ValueType>>>> tr_hdrs_map =
+			  CommonSEGY::default_trace_header);
+    ///
     /// \brief Writes trace to the end of file.
     /// 
     /// \param trace Trace to write.
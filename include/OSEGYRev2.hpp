@@ -38,6 +38,9 @@ public:
 	/// from 0.
     /// Header value should not overlap 240 bytes.
     /// Maps value is a pair of header values name and header values type.
+    /// Endianness of bin_header chooses byte order of file, with
+    /// CommonSEGY::NATIVE_ENDIANNESS file is written in host byte order and
+    /// IEEE samples are copied without swapping.
     /// 
     /// \param file_name Name of SEGY file.
     /// \param text_headers Vector with SEGY text header and extended text
@@ -56,6 +59,23 @@ public:
 			  std::pair<std::string, Trace::Header::ValueType>>>> tr_hdr_map =
 			  CommonSEGY::default_trace_header);
     ///
+    /// \brief Opens existing SEGY file to append traces.
+    /// Binary header of file is used for writing. Trailer stanzas are moved
+    /// after new traces on destruction, nonzero number of traces in binary
+    /// header is updated.
+    /// 
+    /// \param file_name Name of SEGY file.
+    /// \param append Tag to choose this constructor.
+    /// \param tr_hdr_map Trace header map.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    /// 
+    OSEGYRev2(std::string file_name, Append append,
+	  		  std::vector<std::pair<std::string, std::map<uint32_t,
+			  std::pair<std::string, Trace::Header::ValueType>>>> tr_hdr_map =
+			  CommonSEGY::default_trace_header);
+    ///
     /// \brief Writes trace to the end of file.
     /// 
     /// \param trace Trace to write.
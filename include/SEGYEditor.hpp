@@ -0,0 +1,113 @@
+///
+/// @file SEGYEditor.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with SEGYEditor class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_SEGYEDITOR_HPP
+#define SEDAMAN_SEGYEDITOR_HPP
+
+#include "CommonSEGY.hpp"
+#include "Trace.hpp"
+#include <functional>
+#include <memory>
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Class for editing headers of existing SEGY file in place.
+/// Only 240 bytes blocks of trace headers which really change are written
+/// back, samples are never read or written. Values missing in trace header
+/// map keep their bytes. Layout of file (sample format, number of samples,
+/// number of additional headers etc.) could not be changed.
+/// \class SEGYEditor
+///
+///
+class SEGYEditor {
+public:
+    ///
+    /// \brief Construct a new SEGYEditor object
+    ///
+    /// \param file_name Name of SEGY file, it must not be compressed.
+    /// \param hdr_map Could be used to override trace header schema from
+    /// standard
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    SEGYEditor(std::string file_name,
+        std::vector<std::pair<std::string, std::map<uint32_t,
+        std::pair<std::string, Trace::Header::ValueType>>>> hdr_map =
+        CommonSEGY::default_trace_header);
+    ///
+    /// \brief returns binary header
+    ///
+    /// \return CommonSEGY::BinaryHeader const&
+    ///
+    CommonSEGY::BinaryHeader const& binary_header();
+    ///
+    /// \brief writes binary header to file
+    ///
+    /// \param bh New binary header.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception if layout of file is changed
+    ///
+    void write_binary_header(CommonSEGY::BinaryHeader const& bh);
+    ///
+    /// \brief returns number of traces in file
+    ///
+    /// \return uint64_t
+    ///
+    uint64_t traces_count();
+    ///
+    /// \brief reads headers of trace
+    ///
+    /// \param num ordinal number of trace starting from 0
+    /// \return Trace::Header
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception if there is no such trace
+    ///
+    Trace::Header read_header(uint64_t num);
+    ///
+    /// \brief writes values of header to trace
+    /// Values not set in hdr are kept.
+    ///
+    /// \param num ordinal number of trace starting from 0
+    /// \param hdr Values to write.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception if there is no such trace or number of
+    /// samples of variable length trace is changed
+    ///
+    void write_header(uint64_t num, Trace::Header const& hdr);
+    ///
+    /// \brief passes headers of every trace to func and writes changes
+    /// Trace headers are read in one sequential pass.
+    ///
+    /// \param func Called with ordinal number of trace and its headers,
+    /// which could be modified.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception if number of samples of variable length
+    /// trace is changed
+    ///
+    void edit_headers(std::function<void(uint64_t, Trace::Header&)> func);
+    ~SEGYEditor();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_SEGYEDITOR_HPP
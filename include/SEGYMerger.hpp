@@ -0,0 +1,87 @@
+///
+/// @file SEGYMerger.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with SEGYMerger class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_SEGYMERGER_HPP
+#define SEDAMAN_SEGYMERGER_HPP
+
+#include "CommonSEGY.hpp"
+#include "Trace.hpp"
+#include <map>
+#include <memory>
+#include <string>
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Concatenates SEGY files with the same trace layout.
+/// Text headers and binary header are taken from the first file with
+/// traces, files without traces are skipped. Traces
+/// are copied as raw bytes in big blocks, samples and headers are not
+/// decoded. Only chosen trace header values could be renumbered, they get
+/// ordinal number of trace in output starting from 1. Trailer stanzas are
+/// not copied, for revision 2 number of traces is set on close.
+/// \class SEGYMerger
+///
+///
+class SEGYMerger {
+public:
+    ///
+    /// \brief Construct a new SEGYMerger object
+    ///
+    /// \param file_name Name of output file.
+    /// \param renumber Names of trace header values to renumber, e.g.
+    /// TRC_SEQ_LINE and TRC_SEQ_SGY.
+    /// \param hdr_map Could be used to override trace header schema from
+    /// standard, it is used to find values to renumber.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    ///
+    SEGYMerger(std::string file_name, std::vector<std::string> renumber = {},
+        std::vector<std::pair<std::string, std::map<uint32_t,
+        std::pair<std::string, Trace::Header::ValueType>>>> hdr_map =
+        CommonSEGY::default_trace_header);
+    ///
+    /// \brief appends all traces of file to output
+    ///
+    /// \param file_name Name of SEGY file.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception if sample format or trace length differ
+    /// from the first file
+    ///
+    void add(std::string const& file_name);
+    ///
+    /// \brief returns number of traces written so far
+    ///
+    /// \return uint64_t
+    ///
+    uint64_t traces_count();
+    ///
+    /// \brief completes binary header and closes output
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    ///
+    void close();
+    ///
+    /// \brief Closes output, errors are lost, call close to get them.
+    ///
+    ~SEGYMerger();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_SEGYMERGER_HPP
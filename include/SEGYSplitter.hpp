@@ -0,0 +1,81 @@
+///
+/// @file SEGYSplitter.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with SEGYSplitter class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_SEGYSPLITTER_HPP
+#define SEDAMAN_SEGYSPLITTER_HPP
+
+#include "CommonSEGY.hpp"
+#include "Trace.hpp"
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Splits SEGY file into many files by trace header value.
+/// Input is read once. Traces are buffered for every output and buffers
+/// are written when total size exceeds memory budget, biggest first.
+/// Buffered trace headers are kept encoded, so budget is close to memory
+/// really used.
+/// Only limited number of writers is kept open, the least recently used one
+/// is closed and reopened later for appending. Samples are copied without
+/// decoding. Outputs get text headers and binary header of input, number
+/// of traces is set for revision 2, trailer stanzas are not copied.
+/// \class SEGYSplitter
+///
+///
+class SEGYSplitter {
+public:
+    ///
+    /// \brief Construct a new SEGYSplitter object
+    ///
+    /// \param file_name Name of SEGY file to split.
+    /// \param key Name of trace header value to split by.
+    /// \param output_name Gives name of output file for value of key.
+    /// \param max_open Maximal number of simultaneously open outputs.
+    /// \param memory_budget Maximal size of buffered traces in bytes.
+    /// \param hdr_map Could be used to override trace header schema from
+    /// standard
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    SEGYSplitter(std::string file_name, std::string key,
+        std::function<std::string(Trace::Header::Value const&)> output_name,
+        size_t max_open = 64, size_t memory_budget = 64 << 20,
+        std::vector<std::pair<std::string, std::map<uint32_t,
+        std::pair<std::string, Trace::Header::ValueType>>>> hdr_map =
+        CommonSEGY::default_trace_header);
+    ///
+    /// \brief reads input and writes all outputs
+    /// Existing output files are overwritten.
+    ///
+    /// \return std::map<std::string, uint64_t> number of traces for every
+    /// output file
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception if some trace has no key value
+    ///
+    std::map<std::string, uint64_t> split();
+    ~SEGYSplitter();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_SEGYSPLITTER_HPP
@@ -0,0 +1,81 @@
+///
+/// @file SEGYTee.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with SEGYTee class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_SEGYTEE_HPP
+#define SEDAMAN_SEGYTEE_HPP
+
+#include "OSEGY.hpp"
+#include "Trace.hpp"
+#include <memory>
+#include <vector>
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Writes every trace to several SEGY writers.
+/// The first trace is written by every writer as usual, it could complete
+/// binary header. After it writers with the same sample format, byte
+/// order, trace length and trace header map do not encode traces, bytes
+/// encoded by the first of them are written. Writers differing only in
+/// sample format or quantization, e.g. quantized preview, copy encoded
+/// trace headers of not quantized writer and encode only samples.
+/// \class SEGYTee
+///
+///
+class SEGYTee {
+public:
+    ///
+    /// \brief Construct a new SEGYTee object
+    ///
+    /// \param outputs Writers to write traces to, they are owned by tee.
+    ///
+    SEGYTee(std::vector<std::unique_ptr<OSEGY>> outputs);
+    ///
+    /// \brief writes trace to all writers
+    ///
+    /// \param tr Trace to write.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    void write_trace(Trace& tr);
+    ///
+    /// \brief writes traces to all writers
+    /// Every writer gets the batch by one write call.
+    ///
+    /// \param traces Traces to write.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    void write_traces(std::vector<Trace>& traces);
+    ///
+    /// \brief returns writer
+    ///
+    /// \param i Index of writer in order of constructor.
+    /// \return OSEGY&
+    ///
+    OSEGY& output(size_t i);
+    ///
+    /// \brief Destroys writers in order of constructor.
+    ///
+    ~SEGYTee();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_SEGYTEE_HPP
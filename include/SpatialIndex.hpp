@@ -0,0 +1,99 @@
+///
+/// @file SpatialIndex.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with SpatialIndex class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_SPATIALINDEX_HPP
+#define SEDAMAN_SPATIALINDEX_HPP
+
+#include "ISEGY.hpp"
+#include <utility>
+#include <vector>
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief k-d tree over trace coordinates.
+/// Coordinates are taken from trace headers in one header only pass, with
+/// coordinate scalar applied. Queries return ordinal numbers of traces in
+/// ascending order, which could be passed to ISEGY::seek_trace.
+/// \class SpatialIndex
+///
+///
+class SpatialIndex {
+public:
+    ///
+    /// \brief Builds index for all traces of file.
+    ///
+    /// \param segy Opened SEGY file.
+    /// \param x_name Name of trace header value with X coordinate.
+    /// \param y_name Name of trace header value with Y coordinate.
+    /// \param scalar_name Name of trace header value with coordinate
+    /// scalar. Positive scalar is used as multiplier, negative as divisor.
+    /// Coordinates are used as is if there is no such value in headers.
+    /// \param threads Number of threads, 0 means hardware concurrency.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    SpatialIndex(ISEGY& segy, std::string x_name = "CDP_X",
+                 std::string y_name = "CDP_Y",
+                 std::string scalar_name = "COORD_SCALAR",
+                 unsigned threads = 0);
+    ///
+    /// \brief number of indexed traces
+    ///
+    /// \return uint64_t
+    ///
+    uint64_t size();
+    ///
+    /// \brief coordinates of trace with scalar applied
+    ///
+    /// \param num ordinal number of trace starting from 0
+    /// \return std::pair<double, double> X and Y
+    ///
+    /// \throws sedaman::Exception if there is no such trace
+    ///
+    std::pair<double, double> coordinates(uint64_t num);
+    ///
+    /// \brief finds traces inside rectangle, borders included
+    ///
+    /// \return std::vector<uint64_t> ordinal numbers of traces
+    ///
+    std::vector<uint64_t> query_bbox(double x_min, double y_min,
+                                     double x_max, double y_max);
+    ///
+    /// \brief finds traces inside circle, border included
+    ///
+    /// \param x X coordinate of center
+    /// \param y Y coordinate of center
+    /// \param r radius
+    /// \return std::vector<uint64_t> ordinal numbers of traces
+    ///
+    std::vector<uint64_t> query_radius(double x, double y, double r);
+    ///
+    /// \brief finds traces inside polygon
+    ///
+    /// \param polygon Vertices of polygon, it is closed implicitly.
+    /// \return std::vector<uint64_t> ordinal numbers of traces
+    ///
+    std::vector<uint64_t>
+    query_polygon(std::vector<std::pair<double, double>> const& polygon);
+    ~SpatialIndex();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_SPATIALINDEX_HPP
@@ -12,6 +12,7 @@
 #define SEDAMAN_TRACE_HPP
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -112,6 +113,14 @@ public:
         /// \return std::vector<std::string> 
         ///
         std::vector<std::string> keys() const;
+        ///
+        /// \brief calls function for every key and value
+        /// Nothing is copied, so it is cheaper than keys() with get().
+        /// 
+        /// \param func Called with key and value.
+        ///
+        void for_each(std::function<void(std::string const&, Value const&)>
+                          func) const;
 
     private:
         class Impl;
@@ -137,6 +146,13 @@ public:
     ///
     Trace(std::unordered_map<std::string, Header::Value> hdr,
         std::vector<double> smpl);
+    ///
+    /// \brief Construct a new Trace object
+    /// 
+    /// \param hdr Header
+    /// \param smpl Sample values
+    ///
+    Trace(Header hdr, std::vector<double> smpl);
     ~Trace();
     ///
     /// \brief copy assignment
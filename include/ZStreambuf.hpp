@@ -0,0 +1,124 @@
+///
+/// @file ZStreambuf.hpp
+/// @author Andrei Voronin (andalevor@gmail.com)
+/// \brief header file with ZStreambuf class declaration
+/// @version 0.1
+/// \date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+///
+
+#ifndef SEDAMAN_ZSTREAMBUF_HPP
+#define SEDAMAN_ZSTREAMBUF_HPP
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+///
+/// \brief General namespace for sedaman library.
+/// \namespace sedaman
+///
+///
+namespace sedaman {
+///
+/// \brief Stream buffer reading gzip or zlib compressed file.
+/// Data are decompressed on the fly. Every span bytes of output a seek point
+/// is remembered (position in both streams and last 32 KiB of output), so
+/// seek goes to the nearest point before wanted position instead of start
+/// of file. Points could be saved to index file next to compressed file,
+/// then they are loaded on open and even first seek is cheap.
+/// Without index seek to end of file decompresses whole file once.
+/// \class ZStreambuf
+///
+///
+class ZStreambuf : public std::streambuf {
+public:
+    ///
+    /// \brief Default distance between seek points.
+    ///
+    ///
+    static constexpr uint64_t DEFAULT_SPAN = 4 << 20;
+    ///
+    /// \brief checks gzip magic in the first bytes of file
+    /// zlib streams are not detected, their header could not be told from
+    /// plain text header, but could be read by ZStreambuf directly.
+    ///
+    /// \param file_name Name of file to check.
+    /// \return true if file is compressed
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    ///
+    static bool is_compressed(std::string const& file_name);
+    ///
+    /// \brief name of index file for compressed file
+    ///
+    /// \param file_name Name of compressed file.
+    /// \return std::string
+    ///
+    static std::string index_name(std::string const& file_name);
+    ///
+    /// \brief decompresses whole file and saves its seek points to index
+    ///
+    /// \param file_name Name of compressed file.
+    /// \param span Distance between seek points in bytes of output.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    static void write_index(std::string const& file_name,
+                            uint64_t span = DEFAULT_SPAN);
+    ///
+    /// \brief Construct a new ZStreambuf object
+    /// Index file is used if it exists and matches compressed file size.
+    ///
+    /// \param file_name Name of compressed file.
+    /// \param span Distance between seek points in bytes of output.
+    ///
+    /// \throws std::ifstream::failure In case of file operations falure
+    /// \throws sedaman::Exception
+    ///
+    ZStreambuf(std::string const& file_name, uint64_t span = DEFAULT_SPAN);
+    ///
+    /// \brief new buffer over the same file with own position
+    /// Seek points are shared, so points found by one buffer are used
+    /// by others. Buffers could be used from different threads.
+    ///
+    /// \return std::unique_ptr<ZStreambuf>
+    ///
+    std::unique_ptr<ZStreambuf> clone() const;
+    ~ZStreambuf();
+
+protected:
+    int_type underflow() override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+    ZStreambuf(std::unique_ptr<Impl> impl);
+};
+///
+/// \brief Input stream which owns its ZStreambuf.
+/// \class ZIStream
+///
+///
+class ZIStream : public std::istream {
+public:
+    ///
+    /// \brief Construct a new ZIStream object
+    ///
+    /// \param buf Stream buffer to read from.
+    ///
+    ZIStream(std::unique_ptr<ZStreambuf> buf);
+
+private:
+    std::unique_ptr<ZStreambuf> buf;
+};
+} // namespace sedaman
+
+#endif // SEDAMAN_ZSTREAMBUF_HPP
@@ -14,6 +14,9 @@
 #include <bitset>
 #include <cassert>
 #include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <cstdint>
 ///
@@ -188,6 +191,52 @@ void to_bcd(char** buf, T val, bool skip_first, int num)
         --num;
     }
 }
+
+///
+/// \brief splits range into contiguous chunks and processes them in threads
+/// First exception thrown by any of the threads is rethrown in the caller
+/// after all threads are joined.
+/// 
+/// @tparam F 
+/// \param num number of items in range [0, num)
+/// \param threads number of threads, 0 means hardware concurrency
+/// \param func callable with (unsigned thread, uint64_t from, uint64_t to)
+///
+template <typename F>
+void parallel_for(uint64_t num, unsigned threads, F func)
+{
+    if (!threads)
+        threads = std::thread::hardware_concurrency();
+    if (!threads)
+        threads = 1;
+    if (num < threads)
+        threads = num ? num : 1;
+    if (threads == 1) {
+        func(0u, uint64_t(0), num);
+        return;
+    }
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    std::vector<std::thread> pool;
+    uint64_t chunk = num / threads, rest = num % threads, from = 0;
+    for (unsigned i = 0; i < threads; ++i) {
+        uint64_t to = from + chunk + (i < rest ? 1 : 0);
+        pool.emplace_back([&, i, from, to]() {
+            try {
+                func(i, from, to);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        });
+        from = to;
+    }
+    for (auto& t : pool)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
 } // namespace sedaman
 
 #endif // SEDAMAN_UTIL_HPP
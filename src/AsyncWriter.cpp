@@ -0,0 +1,180 @@
+#include "AsyncWriter.hpp"
+#include "Exception.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::condition_variable;
+using std::deque;
+using std::exception_ptr;
+using std::make_unique;
+using std::move;
+using std::mutex;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+namespace sedaman {
+class AsyncWriter::Impl {
+public:
+    Impl(unique_ptr<OSEGY> sgy, unique_ptr<OSEGD> sgd, size_t size);
+    // only one of them is set, used from worker thread only
+    unique_ptr<OSEGY> segy;
+    unique_ptr<OSEGD> segd;
+    size_t queue_size;
+    mutex m;
+    // signals new traces or stop to worker
+    condition_variable has_work;
+    // signals free space in queue or finished batch to callers
+    condition_variable done;
+    deque<Trace> queue;
+    // traces taken by worker and not written yet
+    size_t in_work = 0;
+    // flushes of writer asked by callers and done by worker
+    uint64_t flushes_asked = 0;
+    uint64_t flushes_done = 0;
+    bool stop = false;
+    bool closed = false;
+    exception_ptr error;
+    std::thread worker;
+    void run();
+    void check_error();
+};
+
+AsyncWriter::Impl::Impl(unique_ptr<OSEGY> sgy, unique_ptr<OSEGD> sgd,
+                        size_t size)
+    : segy { move(sgy) }
+    , segd { move(sgd) }
+    , queue_size { std::max<size_t>(size, 1) }
+{
+    worker = std::thread([this] { run(); });
+}
+
+void AsyncWriter::Impl::run()
+{
+    vector<Trace> batch;
+    while (1) {
+        uint64_t flushes;
+        {
+            unique_lock<mutex> lock(m);
+            has_work.wait(lock, [this] {
+                return stop || !queue.empty() || flushes_asked > flushes_done;
+            });
+            if (queue.empty() && flushes_asked == flushes_done)
+                return;
+            batch.assign(std::make_move_iterator(queue.begin()),
+                         std::make_move_iterator(queue.end()));
+            queue.clear();
+            in_work = batch.size();
+            // traces queued before flush was asked are in batch
+            flushes = flushes_asked;
+        }
+        done.notify_all();
+        exception_ptr err;
+        try {
+            if (segy && !batch.empty())
+                segy->write_traces(batch);
+            else if (segd)
+                for (Trace& tr : batch)
+                    segd->write_trace(tr);
+            if (flushes > flushes_done) {
+                if (segy)
+                    segy->flush();
+                else
+                    segd->flush();
+            }
+        } catch (...) {
+            err = std::current_exception();
+        }
+        batch.clear();
+        {
+            unique_lock<mutex> lock(m);
+            in_work = 0;
+            flushes_done = flushes;
+            if (err && !error)
+                error = err;
+            // nothing is written after error
+            if (error)
+                queue.clear();
+        }
+        done.notify_all();
+    }
+}
+
+void AsyncWriter::Impl::check_error()
+{
+    // error is kept, file lacks dropped traces whatever is written later
+    if (error)
+        std::rethrow_exception(error);
+}
+
+AsyncWriter::AsyncWriter(unique_ptr<OSEGY> writer, size_t queue_size)
+    : pimpl { make_unique<Impl>(move(writer), nullptr, queue_size) }
+{
+}
+
+AsyncWriter::AsyncWriter(unique_ptr<OSEGD> writer, size_t queue_size)
+    : pimpl { make_unique<Impl>(nullptr, move(writer), queue_size) }
+{
+}
+
+void AsyncWriter::write_trace(Trace tr)
+{
+    {
+        unique_lock<mutex> lock(pimpl->m);
+        if (pimpl->closed)
+            throw Exception(__FILE__, __LINE__, "writer is closed");
+        pimpl->done.wait(lock, [this] {
+            return pimpl->error || pimpl->queue.size() < pimpl->queue_size;
+        });
+        pimpl->check_error();
+        pimpl->queue.push_back(move(tr));
+    }
+    pimpl->has_work.notify_one();
+}
+
+void AsyncWriter::flush()
+{
+    unique_lock<mutex> lock(pimpl->m);
+    if (pimpl->closed)
+        throw Exception(__FILE__, __LINE__, "writer is closed");
+    pimpl->check_error();
+    uint64_t flush = ++pimpl->flushes_asked;
+    pimpl->has_work.notify_one();
+    pimpl->done.wait(lock, [this, flush] {
+        return pimpl->error || pimpl->flushes_done >= flush;
+    });
+    pimpl->check_error();
+}
+
+void AsyncWriter::close()
+{
+    {
+        unique_lock<mutex> lock(pimpl->m);
+        if (pimpl->closed) {
+            pimpl->check_error();
+            return;
+        }
+        pimpl->closed = true;
+        pimpl->stop = true;
+    }
+    pimpl->has_work.notify_one();
+    pimpl->worker.join();
+    pimpl->segy.reset();
+    pimpl->segd.reset();
+    pimpl->check_error();
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    try {
+        close();
+    } catch (...) {
+    }
+}
+} // namespace sedaman
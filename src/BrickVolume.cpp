@@ -0,0 +1,485 @@
+#include "BrickVolume.hpp"
+#include "Exception.hpp"
+#include "OSEGYRev0.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <zlib.h>
+
+using std::fstream;
+using std::make_unique;
+using std::min;
+using std::move;
+using std::pair;
+using std::streamoff;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace sedaman {
+static char const brk_magic[8] = { 'S', 'D', 'M', 'N', 'B', 'R', 'K', 0 };
+static uint32_t constexpr brk_version = 2;
+// written in native byte order, used to detect files from other hosts
+static uint32_t constexpr brk_endianness = 0x01020304;
+
+class BrickVolume::Impl {
+public:
+    Impl(string name);
+    string file_name;
+    // brick size and number of bricks along inlines, crosslines and samples
+    uint64_t brk[3];
+    uint64_t nbrk[3];
+    ISEGY3D::Grid grid;
+    uint32_t samp_num;
+    uint32_t hdrs_size;
+    int bps;
+    CommonSEGY::BinaryHeader bh;
+    vector<string> text_headers;
+    vector<string> trailer_stanzas;
+    // offset and size of every compressed chunk
+    vector<pair<uint64_t, uint64_t>> index;
+    fstream open_file();
+    uint64_t chunk(uint64_t bi, uint64_t bx, uint64_t k);
+    vector<char> read_brick(fstream& fl, uint64_t bi, uint64_t bx,
+                            uint64_t bs);
+    vector<char> read_headers(fstream& fl, uint64_t bi, uint64_t bx);
+    vector<double> read_samples(uint64_t const il_rng[2],
+                                uint64_t const xl_rng[2], uint32_t first,
+                                uint32_t num);
+    uint64_t il_index(int64_t il);
+    uint64_t xl_index(int64_t xl);
+};
+
+template <typename T>
+static void write_value(fstream& fl, T val)
+{
+    char buf[sizeof(T)];
+    char* ptr = buf;
+    write<T>(&ptr, val);
+    fl.write(buf, sizeof(T));
+}
+
+template <typename T>
+static T read_value(fstream& fl)
+{
+    char buf[sizeof(T)];
+    fl.read(buf, sizeof(T));
+    char const* ptr = buf;
+    return read<T>(&ptr);
+}
+
+static uint64_t ceil_div(uint64_t a, uint64_t b) { return (a + b - 1) / b; }
+
+// samples are XORed with previous sample of the same trace and then bytes
+// of all samples are split into planes. Neighbour samples of seismic trace
+// are close to each other, so most of the planes become almost constant and
+// deflate compresses them a lot better than raw floats.
+static vector<char> pack(vector<char> const& raw, int bps, uint64_t trc_len,
+                         int level)
+{
+    uint64_t n = raw.size() / bps;
+    vector<char> tmp(raw.size());
+    for (uint64_t i = 0; i < n; ++i)
+        for (int b = 0; b < bps; ++b) {
+            char v = raw[i * bps + b];
+            if (i % trc_len)
+                v ^= raw[(i - 1) * bps + b];
+            tmp[b * n + i] = v;
+        }
+    uLongf len = compressBound(tmp.size());
+    vector<char> result(len);
+    if (compress2(reinterpret_cast<Bytef*>(result.data()), &len,
+                  reinterpret_cast<Bytef const*>(tmp.data()), tmp.size(),
+                  level) != Z_OK)
+        throw Exception(__FILE__, __LINE__, "brick compression failed");
+    result.resize(len);
+    return result;
+}
+
+static vector<char> unpack(vector<char> const& packed, uint64_t size,
+                           int bps, uint64_t trc_len)
+{
+    vector<char> tmp(size);
+    uLongf len = size;
+    if (uncompress(reinterpret_cast<Bytef*>(tmp.data()), &len,
+                   reinterpret_cast<Bytef const*>(packed.data()),
+                   packed.size()) != Z_OK || len != size)
+        throw Exception(__FILE__, __LINE__, "corrupted brick in volume");
+    uint64_t n = size / bps;
+    vector<char> raw(size);
+    for (uint64_t i = 0; i < n; ++i)
+        for (int b = 0; b < bps; ++b) {
+            char v = tmp[b * n + i];
+            if (i % trc_len)
+                v ^= raw[(i - 1) * bps + b];
+            raw[i * bps + b] = v;
+        }
+    return raw;
+}
+
+void BrickVolume::from_segy(string segy_name, string file_name,
+                            uint32_t brick_il, uint32_t brick_xl,
+                            uint32_t brick_smp, int level, string il_name,
+                            string xl_name, unsigned threads)
+{
+    if (!brick_il || !brick_xl || !brick_smp)
+        throw Exception(__FILE__, __LINE__, "brick size can not be zero");
+    ISEGY3D in(segy_name, move(il_name), move(xl_name));
+    ISEGY3D::Grid const& g = in.grid();
+    CommonSEGY::BinaryHeader const& bh = in.binary_header();
+    uint32_t samp_num = in.samples_per_trace();
+    uint32_t hdrs_size = in.raw_headers_size();
+    int bps = CommonSEGY::format_bytes(bh.format_code);
+    uint64_t trc_size = hdrs_size + static_cast<uint64_t>(samp_num) * bps;
+    uint64_t nbrk[3] = { ceil_div(g.il_num, brick_il),
+                         ceil_div(g.xl_num, brick_xl),
+                         ceil_div(samp_num, brick_smp) };
+    fstream out;
+    out.exceptions(fstream::failbit | fstream::badbit);
+    out.open(file_name, fstream::out | fstream::binary | fstream::trunc);
+    out.write(brk_magic, sizeof(brk_magic));
+    write_value<uint32_t>(out, brk_version);
+    write_value<uint32_t>(out, brk_endianness);
+    write_value<uint32_t>(out, brick_il);
+    write_value<uint32_t>(out, brick_xl);
+    write_value<uint32_t>(out, brick_smp);
+    write_value<int64_t>(out, g.il_first);
+    write_value<int64_t>(out, g.il_step);
+    write_value<uint64_t>(out, g.il_num);
+    write_value<int64_t>(out, g.xl_first);
+    write_value<int64_t>(out, g.xl_step);
+    write_value<uint64_t>(out, g.xl_num);
+    write_value<uint64_t>(out, g.missing);
+    write_value<uint32_t>(out, samp_num);
+    write_value<uint32_t>(out, hdrs_size);
+    // binary header is kept as it is encoded in SEGY file
+    char bin[CommonSEGY::BIN_HEADER_SIZE] = {};
+    CommonSEGY::format_binary_header(bh, bin);
+    out.write(bin, CommonSEGY::BIN_HEADER_SIZE);
+    write_value<uint32_t>(out, in.text_headers().size());
+    for (string const& s : in.text_headers())
+        out.write(s.data(), CommonSEGY::TEXT_HEADER_SIZE);
+    write_value<uint32_t>(out, in.trailer_stanzas().size());
+    for (string const& s : in.trailer_stanzas())
+        out.write(s.data(), CommonSEGY::TEXT_HEADER_SIZE);
+    std::streampos index_field = out.tellp();
+    write_value<uint64_t>(out, 0);
+    // headers chunk and sample bricks for every column of bricks
+    uint64_t chunks = nbrk[1] * (nbrk[2] + 1);
+    uint64_t nodes = brick_il * brick_xl;
+    vector<pair<uint64_t, uint64_t>> index(nbrk[0] * chunks);
+    for (uint64_t bi = 0; bi < nbrk[0]; ++bi) {
+        // read all traces of row of bricks
+        uint64_t il_from = bi * brick_il;
+        uint64_t il_num = min<uint64_t>(brick_il, g.il_num - il_from);
+        vector<char> row(il_num * g.xl_num * trc_size);
+        vector<char> live(il_num * g.xl_num);
+        parallel_for(live.size(), threads,
+                     [&](unsigned, uint64_t from, uint64_t to) {
+            // compressed input is decompressed from nearest seek point
+            unique_ptr<std::istream> fl = in.open_stream(false);
+            for (uint64_t n = from; n < to; ++n) {
+                auto t = in.trace_number(
+                    g.il_first + (il_from + n / g.xl_num) * g.il_step,
+                    g.xl_first + (n % g.xl_num) * g.xl_step);
+                if (!t)
+                    continue;
+                live[n] = 1;
+                fl->seekg(in.trace_position(*t));
+                fl->read(row.data() + n * trc_size, trc_size);
+            }
+        });
+        // compress bricks of the row
+        vector<vector<char>> packed(chunks);
+        parallel_for(chunks, threads,
+                     [&](unsigned, uint64_t from, uint64_t to) {
+            for (uint64_t c = from; c < to; ++c) {
+                uint64_t bx = c / (nbrk[2] + 1), k = c % (nbrk[2] + 1);
+                uint64_t xl_from = bx * brick_xl;
+                uint64_t xl_num = min<uint64_t>(brick_xl, g.xl_num - xl_from);
+                if (!k) {
+                    // live flags followed by raw trace headers
+                    vector<char> raw(nodes * (1 + hdrs_size));
+                    for (uint64_t i = 0; i < il_num; ++i)
+                        for (uint64_t x = 0; x < xl_num; ++x) {
+                            uint64_t n = i * g.xl_num + xl_from + x;
+                            uint64_t b = i * brick_xl + x;
+                            raw[b] = live[n];
+                            memcpy(raw.data() + nodes + b * hdrs_size,
+                                   row.data() + n * trc_size, hdrs_size);
+                        }
+                    packed[c] = pack(raw, 1, 1, level);
+                } else {
+                    uint64_t s_from = (k - 1) * brick_smp;
+                    uint64_t s_num = min<uint64_t>(brick_smp,
+                                                   samp_num - s_from);
+                    vector<char> raw(nodes * brick_smp * bps);
+                    for (uint64_t i = 0; i < il_num; ++i)
+                        for (uint64_t x = 0; x < xl_num; ++x) {
+                            uint64_t n = i * g.xl_num + xl_from + x;
+                            uint64_t b = i * brick_xl + x;
+                            memcpy(raw.data() + b * brick_smp * bps,
+                                   row.data() + n * trc_size + hdrs_size +
+                                       s_from * bps,
+                                   s_num * bps);
+                        }
+                    packed[c] = pack(raw, bps, brick_smp, level);
+                }
+            }
+        });
+        for (uint64_t c = 0; c < chunks; ++c) {
+            index[bi * chunks + c] = { static_cast<streamoff>(out.tellp()),
+                                       packed[c].size() };
+            out.write(packed[c].data(), packed[c].size());
+        }
+    }
+    uint64_t index_off = static_cast<streamoff>(out.tellp());
+    for (auto& p : index) {
+        write_value<uint64_t>(out, p.first);
+        write_value<uint64_t>(out, p.second);
+    }
+    out.seekp(index_field);
+    write_value<uint64_t>(out, index_off);
+}
+
+BrickVolume::Impl::Impl(string name)
+    : file_name { move(name) }
+{
+    fstream fl = open_file();
+    char mgc[sizeof(brk_magic)];
+    fl.read(mgc, sizeof(mgc));
+    if (memcmp(mgc, brk_magic, sizeof(mgc)))
+        throw Exception(__FILE__, __LINE__, "not a brick volume file");
+    if (read_value<uint32_t>(fl) != brk_version)
+        throw Exception(__FILE__, __LINE__,
+                        "unsupported brick volume version");
+    if (read_value<uint32_t>(fl) != brk_endianness)
+        throw Exception(__FILE__, __LINE__, "unsupported endianness");
+    for (int i = 0; i < 3; ++i)
+        brk[i] = read_value<uint32_t>(fl);
+    grid.il_first = read_value<int64_t>(fl);
+    grid.il_step = read_value<int64_t>(fl);
+    grid.il_num = read_value<uint64_t>(fl);
+    grid.xl_first = read_value<int64_t>(fl);
+    grid.xl_step = read_value<int64_t>(fl);
+    grid.xl_num = read_value<uint64_t>(fl);
+    grid.missing = read_value<uint64_t>(fl);
+    samp_num = read_value<uint32_t>(fl);
+    hdrs_size = read_value<uint32_t>(fl);
+    char bin[CommonSEGY::BIN_HEADER_SIZE];
+    fl.read(bin, CommonSEGY::BIN_HEADER_SIZE);
+    bh = CommonSEGY::parse_binary_header(bin);
+    bps = CommonSEGY::format_bytes(bh.format_code);
+    for (uint32_t i = read_value<uint32_t>(fl); i; --i) {
+        text_headers.emplace_back(CommonSEGY::TEXT_HEADER_SIZE, ' ');
+        fl.read(text_headers.back().data(), CommonSEGY::TEXT_HEADER_SIZE);
+    }
+    for (uint32_t i = read_value<uint32_t>(fl); i; --i) {
+        trailer_stanzas.emplace_back(CommonSEGY::TEXT_HEADER_SIZE, ' ');
+        fl.read(trailer_stanzas.back().data(),
+                CommonSEGY::TEXT_HEADER_SIZE);
+    }
+    fl.seekg(read_value<uint64_t>(fl));
+    nbrk[0] = ceil_div(grid.il_num, brk[0]);
+    nbrk[1] = ceil_div(grid.xl_num, brk[1]);
+    nbrk[2] = ceil_div(samp_num, brk[2]);
+    index.resize(nbrk[0] * nbrk[1] * (nbrk[2] + 1));
+    for (auto& p : index) {
+        p.first = read_value<uint64_t>(fl);
+        p.second = read_value<uint64_t>(fl);
+    }
+}
+
+fstream BrickVolume::Impl::open_file()
+{
+    fstream fl;
+    fl.exceptions(fstream::failbit | fstream::badbit);
+    fl.open(file_name, fstream::in | fstream::binary);
+    return fl;
+}
+
+uint64_t BrickVolume::Impl::chunk(uint64_t bi, uint64_t bx, uint64_t k)
+{
+    return (bi * nbrk[1] + bx) * (nbrk[2] + 1) + k;
+}
+
+vector<char> BrickVolume::Impl::read_brick(fstream& fl, uint64_t bi,
+                                           uint64_t bx, uint64_t bs)
+{
+    auto& p = index[chunk(bi, bx, bs + 1)];
+    vector<char> packed(p.second);
+    fl.seekg(p.first);
+    fl.read(packed.data(), packed.size());
+    return unpack(packed, brk[0] * brk[1] * brk[2] * bps, bps, brk[2]);
+}
+
+vector<char> BrickVolume::Impl::read_headers(fstream& fl, uint64_t bi,
+                                             uint64_t bx)
+{
+    auto& p = index[chunk(bi, bx, 0)];
+    vector<char> packed(p.second);
+    fl.seekg(p.first);
+    fl.read(packed.data(), packed.size());
+    return unpack(packed, brk[0] * brk[1] * (1 + hdrs_size), 1, 1);
+}
+
+uint64_t BrickVolume::Impl::il_index(int64_t il)
+{
+    int64_t i = (il - grid.il_first) / grid.il_step;
+    if ((il - grid.il_first) % grid.il_step || i < 0 ||
+        static_cast<uint64_t>(i) >= grid.il_num)
+        throw Exception(__FILE__, __LINE__, "inline is out of grid");
+    return i;
+}
+
+uint64_t BrickVolume::Impl::xl_index(int64_t xl)
+{
+    int64_t i = (xl - grid.xl_first) / grid.xl_step;
+    if ((xl - grid.xl_first) % grid.xl_step || i < 0 ||
+        static_cast<uint64_t>(i) >= grid.xl_num)
+        throw Exception(__FILE__, __LINE__, "crossline is out of grid");
+    return i;
+}
+
+// reads samples [first, first + num) of traces in inline and crossline
+// index ranges, only bricks crossing requested block are decompressed
+vector<double> BrickVolume::Impl::read_samples(uint64_t const il_rng[2],
+                                               uint64_t const xl_rng[2],
+                                               uint32_t first, uint32_t num)
+{
+    uint64_t xl_num = xl_rng[1] - xl_rng[0];
+    vector<double> result((il_rng[1] - il_rng[0]) * xl_num * num);
+    uint64_t bi0 = il_rng[0] / brk[0], bi1 = ceil_div(il_rng[1], brk[0]);
+    uint64_t bx0 = xl_rng[0] / brk[1], bx1 = ceil_div(xl_rng[1], brk[1]);
+    uint64_t bs0 = first / brk[2], bs1 = ceil_div(first + num, brk[2]);
+    uint64_t nx = bx1 - bx0, ns = bs1 - bs0;
+    parallel_for((bi1 - bi0) * nx * ns, 0,
+                 [&](unsigned, uint64_t from, uint64_t to) {
+        fstream fl = open_file();
+        for (uint64_t c = from; c < to; ++c) {
+            uint64_t bi = bi0 + c / (nx * ns), bx = bx0 + c / ns % nx;
+            uint64_t bs = bs0 + c % ns;
+            vector<char> raw = read_brick(fl, bi, bx, bs);
+            uint64_t i0 = std::max(il_rng[0], bi * brk[0]);
+            uint64_t i1 = min(il_rng[1], (bi + 1) * brk[0]);
+            uint64_t x0 = std::max(xl_rng[0], bx * brk[1]);
+            uint64_t x1 = min(xl_rng[1], (bx + 1) * brk[1]);
+            uint64_t s0 = std::max<uint64_t>(first, bs * brk[2]);
+            uint64_t s1 = min<uint64_t>(first + num, (bs + 1) * brk[2]);
+            for (uint64_t i = i0; i < i1; ++i)
+                for (uint64_t x = x0; x < x1; ++x) {
+                    uint64_t b = ((i - bi * brk[0]) * brk[1] +
+                                  x - bx * brk[1]) * brk[2] +
+                        s0 - bs * brk[2];
+                    CommonSEGY::read_samples(
+                        raw.data() + b * bps,
+                        result.data() + ((i - il_rng[0]) * xl_num +
+                                         x - xl_rng[0]) * num + s0 - first,
+                        s1 - s0, bh.format_code, bh.endianness);
+                }
+        }
+    });
+    return result;
+}
+
+void BrickVolume::to_segy(string segy_name)
+{
+    Impl& d = *pimpl;
+    CommonSEGY::BinaryHeader obh = d.bh;
+    // traces follow headers in new file
+    obh.byte_off_of_first_tr = 0;
+    unique_ptr<OSEGY> out;
+    if (obh.SEGY_rev_major_ver == 0)
+        out = make_unique<OSEGYRev0>(move(segy_name), d.text_headers[0], obh);
+    else if (obh.SEGY_rev_major_ver == 1)
+        out = make_unique<OSEGYRev1>(move(segy_name), d.text_headers, obh);
+    else
+        out = make_unique<OSEGYRev2>(move(segy_name), d.text_headers, obh,
+                                     d.trailer_stanzas);
+    uint64_t nodes = d.brk[0] * d.brk[1];
+    uint64_t chunks = d.nbrk[1] * (d.nbrk[2] + 1);
+    uint64_t trc_size = d.hdrs_size + static_cast<uint64_t>(d.samp_num) *
+        d.bps;
+    for (uint64_t bi = 0; bi < d.nbrk[0]; ++bi) {
+        vector<vector<char>> raw(chunks);
+        parallel_for(chunks, 0, [&](unsigned, uint64_t from, uint64_t to) {
+            fstream fl = d.open_file();
+            for (uint64_t c = from; c < to; ++c) {
+                uint64_t bx = c / (d.nbrk[2] + 1), k = c % (d.nbrk[2] + 1);
+                raw[c] = k ? d.read_brick(fl, bi, bx, k - 1)
+                           : d.read_headers(fl, bi, bx);
+            }
+        });
+        // stored headers and samples are written as they are, so bytes
+        // out of trace header map are kept
+        uint64_t il_num = min(d.brk[0], d.grid.il_num - bi * d.brk[0]);
+        vector<char> buf;
+        buf.reserve(il_num * d.grid.xl_num * trc_size);
+        uint64_t traces = 0;
+        for (uint64_t i = 0; i < il_num; ++i)
+            for (uint64_t x = 0; x < d.grid.xl_num; ++x) {
+                uint64_t bx = x / d.brk[1];
+                uint64_t b = i * d.brk[1] + x % d.brk[1];
+                char const* hdrs = raw[bx * (d.nbrk[2] + 1)].data();
+                if (!hdrs[b])
+                    continue;
+                char const* hdr = hdrs + nodes + b * d.hdrs_size;
+                buf.insert(buf.end(), hdr, hdr + d.hdrs_size);
+                for (uint64_t bs = 0; bs < d.nbrk[2]; ++bs) {
+                    char const* smpls = raw[bx * (d.nbrk[2] + 1) + 1 + bs]
+                        .data() + b * d.brk[2] * d.bps;
+                    buf.insert(buf.end(), smpls, smpls +
+                               min<uint64_t>(d.brk[2],
+                                             d.samp_num - bs * d.brk[2]) *
+                                   d.bps);
+                }
+                ++traces;
+            }
+        out->write_encoded(buf, traces);
+    }
+}
+
+BrickVolume::BrickVolume(string file_name)
+    : pimpl { make_unique<Impl>(move(file_name)) }
+{
+}
+
+ISEGY3D::Grid const& BrickVolume::grid() { return pimpl->grid; }
+
+uint32_t BrickVolume::samples_per_trace() { return pimpl->samp_num; }
+
+CommonSEGY::BinaryHeader const& BrickVolume::binary_header()
+{
+    return pimpl->bh;
+}
+
+vector<double> BrickVolume::inline_section(int64_t il)
+{
+    uint64_t i = pimpl->il_index(il);
+    uint64_t il_rng[2] = { i, i + 1 };
+    uint64_t xl_rng[2] = { 0, pimpl->grid.xl_num };
+    return pimpl->read_samples(il_rng, xl_rng, 0, pimpl->samp_num);
+}
+
+vector<double> BrickVolume::crossline_section(int64_t xl)
+{
+    uint64_t x = pimpl->xl_index(xl);
+    uint64_t il_rng[2] = { 0, pimpl->grid.il_num };
+    uint64_t xl_rng[2] = { x, x + 1 };
+    return pimpl->read_samples(il_rng, xl_rng, 0, pimpl->samp_num);
+}
+
+vector<double> BrickVolume::time_slice(uint32_t sample)
+{
+    if (sample >= pimpl->samp_num)
+        throw Exception(__FILE__, __LINE__, "sample is out of trace");
+    uint64_t il_rng[2] = { 0, pimpl->grid.il_num };
+    uint64_t xl_rng[2] = { 0, pimpl->grid.xl_num };
+    return pimpl->read_samples(il_rng, xl_rng, sample, 1);
+}
+
+BrickVolume::~BrickVolume() = default;
+} // namespace sedaman
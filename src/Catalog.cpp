@@ -0,0 +1,138 @@
+#include "Catalog.hpp"
+#include "Exception.hpp"
+#include "ISEGD.hpp"
+#include "ZStreambuf.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+using std::fstream;
+using std::make_unique;
+using std::move;
+using std::pair;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace sedaman {
+Catalog::Entry Catalog::probe_segy(string file_name)
+{
+    Entry e = {};
+    e.format = Format::SEGY;
+    // headers of compressed file are inflated, its size says nothing about
+    // number of traces
+    bool compressed = ZStreambuf::is_compressed(file_name);
+    unique_ptr<std::istream> fl;
+    if (compressed)
+        fl = make_unique<ZIStream>(make_unique<ZStreambuf>(file_name));
+    else
+        fl = make_unique<fstream>(file_name, fstream::in | fstream::binary);
+    fl->exceptions(fstream::failbit | fstream::badbit);
+    e.file_size = std::filesystem::file_size(file_name);
+    fl->seekg(CommonSEGY::TEXT_HEADER_SIZE);
+    char buf[CommonSEGY::TEXT_HEADER_SIZE];
+    fl->read(buf, CommonSEGY::BIN_HEADER_SIZE);
+    CommonSEGY::BinaryHeader bh = CommonSEGY::parse_binary_header(buf);
+    e.binary_header = bh;
+    e.samples_per_trace = bh.ext_samp_per_tr ? bh.ext_samp_per_tr
+                          : static_cast<uint16_t>(bh.samp_per_tr);
+    uint64_t first = CommonSEGY::TEXT_HEADER_SIZE +
+        CommonSEGY::BIN_HEADER_SIZE;
+    if (bh.ext_text_headers_num == -1) {
+        // only extended text headers are read to find their end
+        string end_stanza = "((SEG: EndText))";
+        do {
+            fl->read(buf, CommonSEGY::TEXT_HEADER_SIZE);
+            first += CommonSEGY::TEXT_HEADER_SIZE;
+        } while (end_stanza.compare(0, end_stanza.size(), buf,
+                                    end_stanza.size()));
+    } else {
+        first += bh.ext_text_headers_num * CommonSEGY::TEXT_HEADER_SIZE;
+    }
+    if (bh.byte_off_of_first_tr)
+        first = bh.byte_off_of_first_tr;
+    if (bh.num_of_tr_in_file) {
+        e.traces_count = bh.num_of_tr_in_file;
+    } else if (!compressed && (bh.fixed_tr_length || !bh.SEGY_rev_major_ver) &&
+               bh.num_of_trailer_stanza != -1) {
+        uint64_t trc_size = CommonSEGY::TR_HEADER_SIZE *
+            (bh.max_num_add_tr_headers + 1) +
+            static_cast<uint64_t>(e.samples_per_trace) *
+                CommonSEGY::format_bytes(bh.format_code);
+        uint64_t end = e.file_size -
+            bh.num_of_trailer_stanza * CommonSEGY::TEXT_HEADER_SIZE;
+        e.traces_count = end > first ? (end - first) / trc_size : 0;
+    }
+    e.file_name = move(file_name);
+    return e;
+}
+
+Catalog::Entry Catalog::probe_segd(string file_name)
+{
+    Entry e = {};
+    e.format = Format::SEGD;
+    e.file_size = std::filesystem::file_size(file_name);
+    ISEGD sgd(file_name);
+    e.general_header = sgd.general_header();
+    uint64_t chans = 0;
+    for (auto& scan_type : sgd.channel_set_headers())
+        for (auto& ch_set : scan_type)
+            chans += ch_set.number_of_channels;
+    e.traces_count = chans;
+    e.file_name = move(file_name);
+    return e;
+}
+
+vector<Catalog::Entry> Catalog::scan(string const& dir_name,
+                                     unsigned threads)
+{
+    namespace fs = std::filesystem;
+    auto lower = [](string ext) {
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) {
+            return std::tolower(static_cast<unsigned char>(c));
+        });
+        return ext;
+    };
+    vector<pair<string, Format>> files;
+    for (auto const& de : fs::recursive_directory_iterator(
+             dir_name, fs::directory_options::skip_permission_denied)) {
+        if (!de.is_regular_file())
+            continue;
+        string ext = lower(de.path().extension().string());
+        if (ext == ".sgd" || ext == ".segd") {
+            files.emplace_back(de.path().string(), Format::SEGD);
+            continue;
+        }
+        // compressed SEGY keeps its extension before .gz
+        if (ext == ".gz")
+            ext = lower(de.path().stem().extension().string());
+        if (ext == ".sgy" || ext == ".segy")
+            files.emplace_back(de.path().string(), Format::SEGY);
+    }
+    std::sort(files.begin(), files.end());
+    vector<Entry> result(files.size());
+    parallel_for(files.size(), threads,
+                 [&](unsigned, uint64_t from, uint64_t to) {
+        for (uint64_t i = from; i < to; ++i) {
+            try {
+                result[i] = files[i].second == Format::SEGY
+                    ? probe_segy(files[i].first)
+                    : probe_segd(files[i].first);
+            } catch (std::exception& ex) {
+                Entry e = {};
+                e.file_name = files[i].first;
+                e.format = files[i].second;
+                std::error_code ec;
+                uintmax_t size = fs::file_size(files[i].first, ec);
+                e.file_size = ec ? 0 : size;
+                e.error = ex.what();
+                result[i] = move(e);
+            }
+        }
+    });
+    return result;
+}
+} // namespace sedaman
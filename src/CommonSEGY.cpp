@@ -1,11 +1,16 @@
 #include "CommonSEGY.hpp"
 #include "Exception.hpp"
 #include "Trace.hpp"
+#include "util.hpp"
+#include <cmath>
+#include <cstring>
+#include <variant>
 
 using std::fstream;
 using std::ios_base;
 using std::map;
 using std::move;
+using std::ldexp;
 using std::pair;
 using std::string;
 using std::to_string;
@@ -276,6 +281,373 @@ void CommonSEGY::ascii_to_ebcdic(string& ascii)
         *from = a2e[static_cast<uint8_t>(*from)];
 }
 
+int CommonSEGY::format_bytes(int16_t format_code)
+{
+    switch (format_code) {
+    case 1:
+    case 2:
+    case 4:
+    case 5:
+    case 10:
+        return 4;
+    case 3:
+    case 11:
+        return 2;
+    case 6:
+    case 9:
+    case 12:
+        return 8;
+    case 7:
+    case 15:
+        return 3;
+    case 8:
+    case 16:
+        return 1;
+    default:
+        throw Exception(__FILE__, __LINE__, "unsupported format");
+    }
+}
+
+// host order matches file order only for this value of endianness field
+static bool need_swap(int32_t endianness)
+{
+    switch (endianness) {
+    case 0x01020304:
+        return false;
+    case 0:
+    case 0x04030201:
+        return true;
+    default:
+        throw Exception(__FILE__, __LINE__, "unsupported endianness");
+    }
+}
+
+template <typename V>
+static V read_swapped(char const** buf, bool swp)
+{
+    V v = read<V>(buf);
+    return swp ? swap(v) : v;
+}
+
+static uint32_t read_u24(char const** buf, bool swp)
+{
+    if (swp)
+        return swap(read<uint16_t>(buf)) << 8 | read<uint8_t>(buf);
+    else
+        return read<uint16_t>(buf) | read<uint8_t>(buf) << 16;
+}
+
+static int32_t read_i24(char const** buf, bool swp)
+{
+    uint32_t result = read_u24(buf, swp);
+    return result & 0x800000 ? result | 0xff000000 : result;
+}
+
+static double from_ibm(uint32_t ibm)
+{
+    int sign = ibm >> 31 ? -1 : 1;
+    int exp = ibm >> 24 & 0x7f;
+    double fraction = ibm & 0x00ffffff;
+    return sign * ldexp(fraction, 4 * (exp - 64) - 24);
+}
+
+static float from_ieee_single(uint32_t v)
+{
+    float result;
+    memcpy(&result, &v, sizeof(result));
+    return result;
+}
+
+static double from_ieee_double(uint64_t v)
+{
+    double result;
+    memcpy(&result, &v, sizeof(result));
+    return result;
+}
+
+Trace::Header::Value CommonSEGY::read_header_value(char const* buf,
+    Trace::Header::ValueType type, int32_t endianness)
+{
+    bool swp = need_swap(endianness);
+    switch (type) {
+    case Trace::Header::ValueType::int8_t:
+        return read<int8_t>(&buf);
+    case Trace::Header::ValueType::uint8_t:
+        return read<uint8_t>(&buf);
+    case Trace::Header::ValueType::int16_t:
+        return read_swapped<int16_t>(&buf, swp);
+    case Trace::Header::ValueType::uint16_t:
+        return read_swapped<uint16_t>(&buf, swp);
+    case Trace::Header::ValueType::int24_t:
+        return read_i24(&buf, swp);
+    case Trace::Header::ValueType::uint24_t:
+        return read_u24(&buf, swp);
+    case Trace::Header::ValueType::int32_t:
+        return read_swapped<int32_t>(&buf, swp);
+    case Trace::Header::ValueType::uint32_t:
+        return read_swapped<uint32_t>(&buf, swp);
+    case Trace::Header::ValueType::int64_t:
+        return read_swapped<int64_t>(&buf, swp);
+    case Trace::Header::ValueType::uint64_t:
+        return static_cast<int64_t>(read_swapped<uint64_t>(&buf, swp));
+    case Trace::Header::ValueType::ibm:
+        return from_ibm(read_swapped<uint32_t>(&buf, swp));
+    case Trace::Header::ValueType::ieee_single:
+        return static_cast<double>(
+            from_ieee_single(read_swapped<uint32_t>(&buf, swp)));
+    case Trace::Header::ValueType::ieee_double:
+        return from_ieee_double(read_swapped<uint64_t>(&buf, swp));
+    }
+    throw Exception(__FILE__, __LINE__,
+                    "impossible, unexpected type in TrHdrValueType");
+}
+
+template <typename V>
+static void write_swapped(char** buf, V v, bool swp)
+{
+    write<V>(buf, swp ? swap(v) : v);
+}
+
+static void write_u24(char** buf, uint32_t v, bool swp)
+{
+    if (swp) {
+        write<uint16_t>(buf, swap(static_cast<uint16_t>(v >> 8)));
+        write<uint8_t>(buf, v);
+    } else {
+        write<uint16_t>(buf, v);
+        write<uint8_t>(buf, v >> 16);
+    }
+}
+
+static uint32_t to_ibm(double v)
+{
+    if (v == 0 || !std::isfinite(v))
+        return 0;
+    uint32_t sign = v < 0 ? 0x80000000 : 0;
+    int exp;
+    double fraction = std::frexp(std::fabs(v), &exp);
+    // base 16 exponent, fraction is shifted to keep it in [1/16, 1)
+    int shift = (4 - exp % 4) % 4;
+    exp = (exp + shift) / 4;
+    fraction = std::ldexp(fraction, 24 - shift);
+    if (exp + 64 > 127)
+        return sign | 0x7fffffff;
+    if (exp + 64 < 0)
+        return 0;
+    return sign | static_cast<uint32_t>(exp + 64) << 24 |
+        static_cast<uint32_t>(fraction);
+}
+
+static uint32_t as_ieee_single(float v)
+{
+    uint32_t result;
+    memcpy(&result, &v, sizeof(result));
+    return result;
+}
+
+static uint64_t as_ieee_double(double v)
+{
+    uint64_t result;
+    memcpy(&result, &v, sizeof(result));
+    return result;
+}
+
+void CommonSEGY::write_header_value(char* buf, Trace::Header::ValueType type,
+    Trace::Header::Value const& v, int32_t endianness)
+{
+    bool swp = need_swap(endianness);
+    int64_t i = std::holds_alternative<int64_t>(v) ? std::get<int64_t>(v)
+        : std::llround(std::get<double>(v));
+    double d = std::holds_alternative<int64_t>(v) ? std::get<int64_t>(v)
+        : std::get<double>(v);
+    switch (type) {
+    case Trace::Header::ValueType::int8_t:
+    case Trace::Header::ValueType::uint8_t:
+        write<uint8_t>(&buf, i);
+        return;
+    case Trace::Header::ValueType::int16_t:
+    case Trace::Header::ValueType::uint16_t:
+        write_swapped<uint16_t>(&buf, i, swp);
+        return;
+    case Trace::Header::ValueType::int24_t:
+    case Trace::Header::ValueType::uint24_t:
+        write_u24(&buf, i, swp);
+        return;
+    case Trace::Header::ValueType::int32_t:
+    case Trace::Header::ValueType::uint32_t:
+        write_swapped<uint32_t>(&buf, i, swp);
+        return;
+    case Trace::Header::ValueType::int64_t:
+    case Trace::Header::ValueType::uint64_t:
+        write_swapped<uint64_t>(&buf, i, swp);
+        return;
+    case Trace::Header::ValueType::ibm:
+        write_swapped<uint32_t>(&buf, to_ibm(d), swp);
+        return;
+    case Trace::Header::ValueType::ieee_single:
+        write_swapped<uint32_t>(&buf, as_ieee_single(d), swp);
+        return;
+    case Trace::Header::ValueType::ieee_double:
+        write_swapped<uint64_t>(&buf, as_ieee_double(d), swp);
+        return;
+    }
+    throw Exception(__FILE__, __LINE__,
+                    "impossible, unexpected type in TrHdrValueType");
+}
+
+template <typename V, typename T, typename C>
+static void decode(char const* buf, T* out, size_t n, bool swp, C conv)
+{
+    if (swp)
+        for (size_t i = 0; i < n; ++i)
+            out[i] = static_cast<T>(conv(swap(read<V>(&buf))));
+    else
+        for (size_t i = 0; i < n; ++i)
+            out[i] = static_cast<T>(conv(read<V>(&buf)));
+}
+
+template <typename T>
+void CommonSEGY::read_samples(char const* buf, T* out, size_t n,
+    int16_t format_code, int32_t endianness)
+{
+    bool swp = need_swap(endianness);
+    auto same = [](auto v) { return v; };
+    switch (format_code) {
+    case 1:
+        decode<uint32_t>(buf, out, n, swp, from_ibm);
+        break;
+    case 2:
+        decode<int32_t>(buf, out, n, swp, same);
+        break;
+    case 3:
+        decode<int16_t>(buf, out, n, swp, same);
+        break;
+    case 5:
+        decode<uint32_t>(buf, out, n, swp, from_ieee_single);
+        break;
+    case 6:
+        decode<uint64_t>(buf, out, n, swp, from_ieee_double);
+        break;
+    case 7:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = static_cast<T>(read_i24(&buf, swp));
+        break;
+    case 8:
+        decode<int8_t>(buf, out, n, false, same);
+        break;
+    case 9:
+        decode<int64_t>(buf, out, n, swp, same);
+        break;
+    case 10:
+        decode<uint32_t>(buf, out, n, swp, same);
+        break;
+    case 11:
+        decode<uint16_t>(buf, out, n, swp, same);
+        break;
+    case 12:
+        decode<uint64_t>(buf, out, n, swp, same);
+        break;
+    case 15:
+        for (size_t i = 0; i < n; ++i)
+            out[i] = static_cast<T>(read_u24(&buf, swp));
+        break;
+    case 16:
+        decode<uint8_t>(buf, out, n, false, same);
+        break;
+    default:
+        throw Exception(__FILE__, __LINE__, "unsupported format");
+    }
+}
+
+template void CommonSEGY::read_samples<float>(char const*, float*, size_t,
+    int16_t, int32_t);
+template void CommonSEGY::read_samples<double>(char const*, double*, size_t,
+    int16_t, int32_t);
+
+CommonSEGY::BinaryHeader CommonSEGY::parse_binary_header(char const* buf)
+{
+    BinaryHeader bh = {};
+    memcpy(&bh.endianness, buf + 96, sizeof(int32_t));
+    bool swp = need_swap(bh.endianness);
+    bh.job_id = read_swapped<int32_t>(&buf, swp);
+    bh.line_num = read_swapped<int32_t>(&buf, swp);
+    bh.reel_num = read_swapped<int32_t>(&buf, swp);
+    int16_t* i16_fields[] = {
+        &bh.tr_per_ens, &bh.aux_per_ens, &bh.samp_int, &bh.samp_int_orig,
+        &bh.samp_per_tr, &bh.samp_per_tr_orig, &bh.format_code,
+        &bh.ens_fold, &bh.sort_code, &bh.vert_sum_code,
+        &bh.sw_freq_at_start, &bh.sw_freq_at_end, &bh.sw_length,
+        &bh.sw_type_code, &bh.sw_ch_tr_num, &bh.taper_at_start,
+        &bh.taper_at_end, &bh.taper_type, &bh.corr_traces,
+        &bh.bin_gain_recov, &bh.amp_recov_meth, &bh.measure_system,
+        &bh.impulse_sig_pol, &bh.vib_pol_code
+    };
+    for (int16_t* f : i16_fields)
+        *f = read_swapped<int16_t>(&buf, swp);
+    bh.ext_tr_per_ens = read_swapped<int32_t>(&buf, swp);
+    bh.ext_aux_per_ens = read_swapped<int32_t>(&buf, swp);
+    bh.ext_samp_per_tr = read_swapped<int32_t>(&buf, swp);
+    bh.ext_samp_int = from_ieee_double(read_swapped<uint64_t>(&buf, swp));
+    bh.ext_samp_int_orig =
+        from_ieee_double(read_swapped<uint64_t>(&buf, swp));
+    bh.ext_samp_per_tr_orig = read_swapped<int32_t>(&buf, swp);
+    bh.ext_ens_fold = read_swapped<int32_t>(&buf, swp);
+    buf += 204; // skip unassigned fields and endianness
+    bh.SEGY_rev_major_ver = read<uint8_t>(&buf);
+    bh.SEGY_rev_minor_ver = read<uint8_t>(&buf);
+    bh.fixed_tr_length = read_swapped<int16_t>(&buf, swp);
+    bh.ext_text_headers_num = read_swapped<int16_t>(&buf, swp);
+    if (bh.SEGY_rev_major_ver > 1) {
+        bh.max_num_add_tr_headers = read_swapped<int32_t>(&buf, swp);
+        bh.time_basis_code = read_swapped<int16_t>(&buf, swp);
+        bh.num_of_tr_in_file = read_swapped<int64_t>(&buf, swp);
+        bh.byte_off_of_first_tr = read_swapped<uint64_t>(&buf, swp);
+        bh.num_of_trailer_stanza = read_swapped<int32_t>(&buf, swp);
+    }
+    return bh;
+}
+
+void CommonSEGY::format_binary_header(BinaryHeader const& bh, char* buf)
+{
+    bool swp = need_swap(bh.endianness);
+    write_swapped<int32_t>(&buf, bh.job_id, swp);
+    write_swapped<int32_t>(&buf, bh.line_num, swp);
+    write_swapped<int32_t>(&buf, bh.reel_num, swp);
+    int16_t const i16_fields[] = {
+        bh.tr_per_ens, bh.aux_per_ens, bh.samp_int, bh.samp_int_orig,
+        bh.samp_per_tr, bh.samp_per_tr_orig, bh.format_code,
+        bh.ens_fold, bh.sort_code, bh.vert_sum_code,
+        bh.sw_freq_at_start, bh.sw_freq_at_end, bh.sw_length,
+        bh.sw_type_code, bh.sw_ch_tr_num, bh.taper_at_start,
+        bh.taper_at_end, bh.taper_type, bh.corr_traces,
+        bh.bin_gain_recov, bh.amp_recov_meth, bh.measure_system,
+        bh.impulse_sig_pol, bh.vib_pol_code
+    };
+    for (int16_t f : i16_fields)
+        write_swapped<int16_t>(&buf, f, swp);
+    write_swapped<int32_t>(&buf, bh.ext_tr_per_ens, swp);
+    write_swapped<int32_t>(&buf, bh.ext_aux_per_ens, swp);
+    write_swapped<int32_t>(&buf, bh.ext_samp_per_tr, swp);
+    write_swapped<uint64_t>(&buf, as_ieee_double(bh.ext_samp_int), swp);
+    write_swapped<uint64_t>(&buf, as_ieee_double(bh.ext_samp_int_orig), swp);
+    write_swapped<int32_t>(&buf, bh.ext_samp_per_tr_orig, swp);
+    write_swapped<int32_t>(&buf, bh.ext_ens_fold, swp);
+    // endianness is written as is, it is the byte order itself
+    write<int32_t>(&buf, bh.endianness);
+    buf += 200;
+    write<uint8_t>(&buf, bh.SEGY_rev_major_ver);
+    write<uint8_t>(&buf, bh.SEGY_rev_minor_ver);
+    write_swapped<int16_t>(&buf, bh.fixed_tr_length, swp);
+    write_swapped<int16_t>(&buf, bh.ext_text_headers_num, swp);
+    if (bh.SEGY_rev_major_ver > 1) {
+        write_swapped<int32_t>(&buf, bh.max_num_add_tr_headers, swp);
+        write_swapped<int16_t>(&buf, bh.time_basis_code, swp);
+        write_swapped<int64_t>(&buf, bh.num_of_tr_in_file, swp);
+        write_swapped<uint64_t>(&buf, bh.byte_off_of_first_tr, swp);
+        write_swapped<int32_t>(&buf, bh.num_of_trailer_stanza, swp);
+    }
+}
+
 static char const* bin_names[] = {
     "Job identification number",
     "Line number",
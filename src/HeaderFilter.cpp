@@ -0,0 +1,310 @@
+#include "HeaderFilter.hpp"
+#include "Exception.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using std::make_unique;
+using std::move;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace sedaman {
+// expression is kept in postfix form and evaluated on small stack
+static int constexpr max_depth = 64;
+
+class HeaderFilter::Impl {
+public:
+    enum class OpCode { num, load, neg, lnot, mul, div, mod, add, sub, lt,
+                        le, gt, ge, eq, ne, land, lor };
+    class Instr {
+    public:
+        OpCode op;
+        double num;
+        uint32_t off;
+        Trace::Header::ValueType type;
+    };
+    Impl(string const& expr, ISEGY& s);
+    vector<Instr> code;
+    vector<string> names;
+    int32_t endianness;
+    bool matches(char const* hdrs) const;
+    class Parser;
+};
+
+// recursive descent parser, emits code in postfix order
+class HeaderFilter::Impl::Parser {
+public:
+    Parser(string const& expr, ISEGY& s, HeaderFilter::Impl& f);
+
+private:
+    string const& src;
+    string::size_type pos = 0;
+    ISEGY& sgy;
+    HeaderFilter::Impl& flt;
+    int depth = 0;
+    void skip_spaces();
+    bool accept(char const* token);
+    [[noreturn]] void error(string const& msg);
+    void emit(OpCode op, int change);
+    void parse_or();
+    void parse_and();
+    void parse_cmp();
+    void parse_sum();
+    void parse_prod();
+    void parse_unary();
+    void parse_primary();
+};
+
+HeaderFilter::Impl::Impl(string const& expr, ISEGY& s)
+    : endianness { s.binary_header().endianness }
+{
+    Parser { expr, s, *this };
+}
+
+HeaderFilter::Impl::Parser::Parser(string const& expr, ISEGY& s,
+                                   HeaderFilter::Impl& f)
+    : src { expr }
+    , sgy { s }
+    , flt { f }
+{
+    parse_or();
+    skip_spaces();
+    if (pos != src.size())
+        error("unexpected symbol");
+}
+
+void HeaderFilter::Impl::Parser::skip_spaces()
+{
+    while (pos < src.size() &&
+           std::isspace(static_cast<unsigned char>(src[pos])))
+        ++pos;
+}
+
+bool HeaderFilter::Impl::Parser::accept(char const* token)
+{
+    skip_spaces();
+    if (src.compare(pos, std::char_traits<char>::length(token), token))
+        return false;
+    // do not take < from <=, ! from != and so on
+    string::size_type next = pos + std::char_traits<char>::length(token);
+    if ((!strcmp(token, "<") || !strcmp(token, ">") || !strcmp(token, "!")) &&
+        next < src.size() && src[next] == '=')
+        return false;
+    pos = next;
+    return true;
+}
+
+void HeaderFilter::Impl::Parser::error(string const& msg)
+{
+    throw Exception(__FILE__, __LINE__,
+                    "filter expression: " + msg + " at position " +
+                        std::to_string(pos));
+}
+
+void HeaderFilter::Impl::Parser::emit(OpCode op, int change)
+{
+    flt.code.push_back({ op, 0, 0, Trace::Header::ValueType::int8_t });
+    depth += change;
+}
+
+void HeaderFilter::Impl::Parser::parse_or()
+{
+    parse_and();
+    while (accept("||")) {
+        parse_and();
+        emit(OpCode::lor, -1);
+    }
+}
+
+void HeaderFilter::Impl::Parser::parse_and()
+{
+    parse_cmp();
+    while (accept("&&")) {
+        parse_cmp();
+        emit(OpCode::land, -1);
+    }
+}
+
+void HeaderFilter::Impl::Parser::parse_cmp()
+{
+    parse_sum();
+    static pair<char const*, OpCode> const ops[] = {
+        { "==", OpCode::eq }, { "!=", OpCode::ne }, { "<=", OpCode::le },
+        { ">=", OpCode::ge }, { "<", OpCode::lt },  { ">", OpCode::gt }
+    };
+    for (auto& p : ops)
+        if (accept(p.first)) {
+            parse_sum();
+            emit(p.second, -1);
+            return;
+        }
+}
+
+void HeaderFilter::Impl::Parser::parse_sum()
+{
+    parse_prod();
+    for (;;) {
+        if (accept("+")) {
+            parse_prod();
+            emit(OpCode::add, -1);
+        } else if (accept("-")) {
+            parse_prod();
+            emit(OpCode::sub, -1);
+        } else {
+            return;
+        }
+    }
+}
+
+void HeaderFilter::Impl::Parser::parse_prod()
+{
+    parse_unary();
+    for (;;) {
+        if (accept("*")) {
+            parse_unary();
+            emit(OpCode::mul, -1);
+        } else if (accept("/")) {
+            parse_unary();
+            emit(OpCode::div, -1);
+        } else if (accept("%")) {
+            parse_unary();
+            emit(OpCode::mod, -1);
+        } else {
+            return;
+        }
+    }
+}
+
+void HeaderFilter::Impl::Parser::parse_unary()
+{
+    if (accept("-")) {
+        parse_unary();
+        emit(OpCode::neg, 0);
+    } else if (accept("!")) {
+        parse_unary();
+        emit(OpCode::lnot, 0);
+    } else if (accept("+")) {
+        parse_unary();
+    } else {
+        parse_primary();
+    }
+}
+
+void HeaderFilter::Impl::Parser::parse_primary()
+{
+    skip_spaces();
+    if (pos == src.size())
+        error("unexpected end");
+    char c = src[pos];
+    if (accept("(")) {
+        parse_or();
+        if (!accept(")"))
+            error("missing )");
+        return;
+    }
+    Instr in = { OpCode::num, 0, 0, Trace::Header::ValueType::int8_t };
+    if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+        char* end;
+        in.num = std::strtod(src.c_str() + pos, &end);
+        pos = end - src.c_str();
+    } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+        string::size_type from = pos;
+        while (pos < src.size() &&
+               (std::isalnum(static_cast<unsigned char>(src[pos])) ||
+                src[pos] == '_'))
+            ++pos;
+        string name = src.substr(from, pos - from);
+        auto off = sgy.raw_header_offset(name);
+        if (!off) {
+            pos = from;
+            error("no such header in trace " + name);
+        }
+        in.op = OpCode::load;
+        in.off = off->first;
+        in.type = off->second;
+        if (std::find(flt.names.begin(), flt.names.end(), name) ==
+            flt.names.end())
+            flt.names.push_back(move(name));
+    } else {
+        error("unexpected symbol");
+    }
+    flt.code.push_back(in);
+    if (++depth > max_depth)
+        error("expression is too complex");
+}
+
+bool HeaderFilter::Impl::matches(char const* hdrs) const
+{
+    double st[max_depth];
+    int top = -1;
+    for (Instr const& in : code) {
+        switch (in.op) {
+        case OpCode::num:
+            st[++top] = in.num;
+            continue;
+        case OpCode::load: {
+            Trace::Header::Value v = CommonSEGY::read_header_value(
+                hdrs + in.off, in.type, endianness);
+            st[++top] = std::holds_alternative<int64_t>(v)
+                ? std::get<int64_t>(v) : std::get<double>(v);
+            continue;
+        }
+        case OpCode::neg:
+            st[top] = -st[top];
+            continue;
+        case OpCode::lnot:
+            st[top] = !st[top];
+            continue;
+        default:
+            break;
+        }
+        double b = st[top--];
+        double& a = st[top];
+        switch (in.op) {
+        case OpCode::mul: a *= b; break;
+        case OpCode::div: a /= b; break;
+        case OpCode::mod: a = std::fmod(a, b); break;
+        case OpCode::add: a += b; break;
+        case OpCode::sub: a -= b; break;
+        case OpCode::lt: a = a < b; break;
+        case OpCode::le: a = a <= b; break;
+        case OpCode::gt: a = a > b; break;
+        case OpCode::ge: a = a >= b; break;
+        case OpCode::eq: a = a == b; break;
+        case OpCode::ne: a = a != b; break;
+        case OpCode::land: a = a && b; break;
+        case OpCode::lor: a = a || b; break;
+        default: break;
+        }
+    }
+    return st[0];
+}
+
+HeaderFilter::HeaderFilter(string const& expression, ISEGY& segy)
+    : pimpl { make_unique<Impl>(expression, segy) }
+{
+}
+
+HeaderFilter::HeaderFilter(HeaderFilter const& f)
+    : pimpl { make_unique<Impl>(*f.pimpl) }
+{
+}
+
+HeaderFilter::HeaderFilter(HeaderFilter&& f) noexcept
+    : pimpl { move(f.pimpl) }
+{
+}
+
+bool HeaderFilter::matches(char const* raw_hdrs) const
+{
+    return pimpl->matches(raw_hdrs);
+}
+
+vector<string> const& HeaderFilter::names() const { return pimpl->names; }
+
+HeaderFilter::~HeaderFilter() = default;
+} // namespace sedaman
@@ -0,0 +1,221 @@
+#include "HeaderStats.hpp"
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+using std::map;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace sedaman {
+// HyperLogLog registers number is 2^hll_bits
+static int constexpr hll_bits = 10;
+
+static int64_t floor_half(int64_t k) { return k >= 0 ? k / 2 : -((1 - k) / 2); }
+
+static uint64_t mix(uint64_t h)
+{
+    h += 0x9e3779b97f4a7c15;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111eb;
+    return h ^ (h >> 31);
+}
+
+// accumulates one value for part of traces, accumulators of different
+// threads are merged at the end
+class Accumulator {
+public:
+    uint64_t count = 0;
+    // values taken into min, max, mean and bins
+    uint64_t finite = 0;
+    uint64_t nonzero = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double sum = 0;
+    // bins are 2^scale wide, key is number of bin counting from zero
+    int scale = -16;
+    map<int64_t, uint64_t> bins;
+    vector<uint8_t> hll = vector<uint8_t>(1 << hll_bits);
+    void add(Trace::Header::Value const& v, unsigned max_bins);
+    void widen();
+    void fit(unsigned max_bins);
+    void merge(Accumulator& a, unsigned max_bins);
+    HeaderStats::Field result(string name);
+};
+
+void Accumulator::add(Trace::Header::Value const& v, unsigned max_bins)
+{
+    ++count;
+    double d;
+    uint64_t bits;
+    if (std::holds_alternative<int64_t>(v)) {
+        d = std::get<int64_t>(v);
+        bits = std::get<int64_t>(v);
+    } else {
+        d = std::get<double>(v);
+        memcpy(&bits, &d, sizeof(bits));
+    }
+    uint64_t h = mix(bits);
+    uint8_t rank = std::countl_zero(h << hll_bits | 1 << (hll_bits - 1)) + 1;
+    uint8_t& reg = hll[h >> (64 - hll_bits)];
+    reg = std::max(reg, rank);
+    // infinity would widen bins forever
+    if (!std::isfinite(d))
+        return;
+    ++finite;
+    if (d)
+        ++nonzero;
+    min = std::min(min, d);
+    max = std::max(max, d);
+    sum += d;
+    while (std::fabs(std::ldexp(d, -scale)) > 0x1p62)
+        widen();
+    ++bins[static_cast<int64_t>(std::floor(std::ldexp(d, -scale)))];
+    fit(max_bins);
+}
+
+void Accumulator::widen()
+{
+    map<int64_t, uint64_t> wide;
+    for (auto& p : bins)
+        wide[floor_half(p.first)] += p.second;
+    bins = std::move(wide);
+    ++scale;
+}
+
+void Accumulator::fit(unsigned max_bins)
+{
+    while (!bins.empty() &&
+           static_cast<uint64_t>(bins.rbegin()->first - bins.begin()->first) >=
+               max_bins)
+        widen();
+}
+
+void Accumulator::merge(Accumulator& a, unsigned max_bins)
+{
+    count += a.count;
+    finite += a.finite;
+    nonzero += a.nonzero;
+    min = std::min(min, a.min);
+    max = std::max(max, a.max);
+    sum += a.sum;
+    while (scale < a.scale)
+        widen();
+    while (a.scale < scale)
+        a.widen();
+    for (auto& p : a.bins)
+        bins[p.first] += p.second;
+    fit(max_bins);
+    for (decltype(hll.size()) i = 0; i < hll.size(); ++i)
+        hll[i] = std::max(hll[i], a.hll[i]);
+}
+
+HeaderStats::Field Accumulator::result(string name)
+{
+    HeaderStats::Field f = {};
+    f.name = std::move(name);
+    f.count = count;
+    f.nonzero = nonzero;
+    if (!bins.empty()) {
+        f.min = min;
+        f.max = max;
+        f.mean = sum / finite;
+    }
+    double m = hll.size(), z = 0;
+    uint64_t zeros = 0;
+    for (uint8_t r : hll) {
+        z += std::ldexp(1, -r);
+        zeros += !r;
+    }
+    double est = 0.7213 / (1 + 1.079 / m) * m * m / z;
+    // linear counting is more precise for small cardinalities
+    if (est <= 2.5 * m && zeros)
+        est = m * std::log(m / zeros);
+    f.distinct = count ? std::max<uint64_t>(1, std::llround(est)) : 0;
+    f.bin_width = std::ldexp(1, scale);
+    if (!bins.empty()) {
+        f.bin_start = bins.begin()->first * f.bin_width;
+        f.histogram.resize(bins.rbegin()->first - bins.begin()->first + 1);
+        for (auto& p : bins)
+            f.histogram[p.first - bins.begin()->first] = p.second;
+    }
+    return f;
+}
+
+using HdrMap = vector<pair<string, map<uint32_t,
+    pair<string, Trace::Header::ValueType>>>>;
+using CacheKey = std::tuple<string, uintmax_t, int64_t, unsigned, HdrMap>;
+
+static std::mutex cache_mutex;
+static map<CacheKey, vector<HeaderStats::Field>> cache;
+
+vector<HeaderStats::Field> HeaderStats::compute(string file_name,
+                                                HdrMap tr_hdr_map,
+                                                unsigned bins,
+                                                unsigned threads)
+{
+    if (!bins)
+        throw Exception(__FILE__, __LINE__,
+                        "number of histogram bins can not be zero");
+    namespace fs = std::filesystem;
+    fs::path path = fs::canonical(file_name);
+    CacheKey key { path.string(), fs::file_size(path),
+                   fs::last_write_time(path).time_since_epoch().count(),
+                   bins, tr_hdr_map };
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = cache.find(key);
+        if (it != cache.end())
+            return it->second;
+    }
+    ISEGY segy(file_name, tr_hdr_map);
+    int32_t endianness = segy.binary_header().endianness;
+    uint32_t hdrs_size = segy.raw_headers_size();
+    vector<string> names;
+    vector<pair<uint32_t, Trace::Header::ValueType>> offs;
+    for (decltype(tr_hdr_map.size()) i = 0; i < tr_hdr_map.size() &&
+         i * CommonSEGY::TR_HEADER_SIZE < hdrs_size; ++i)
+        for (auto& p : tr_hdr_map[i].second)
+            if (std::find(names.begin(), names.end(), p.second.first) ==
+                names.end()) {
+                names.push_back(p.second.first);
+                offs.push_back(*segy.raw_header_offset(p.second.first));
+            }
+    if (!threads)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    vector<vector<Accumulator>> accs(threads,
+                                     vector<Accumulator>(names.size()));
+    segy.read_raw_headers([&](unsigned thr, uint64_t, char const* hdr) {
+        vector<Accumulator>& a = accs[thr];
+        for (decltype(offs.size()) i = 0; i < offs.size(); ++i)
+            a[i].add(CommonSEGY::read_header_value(hdr + offs[i].first,
+                                                   offs[i].second,
+                                                   endianness),
+                     bins);
+    }, threads);
+    vector<Field> result;
+    for (decltype(names.size()) i = 0; i < names.size(); ++i) {
+        for (unsigned t = 1; t < threads; ++t)
+            accs[0][i].merge(accs[t][i], bins);
+        result.push_back(accs[0][i].result(names[i]));
+    }
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache[std::move(key)] = result;
+    return result;
+}
+
+void HeaderStats::clear_cache()
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache.clear();
+}
+} // namespace sedaman
@@ -34,11 +34,18 @@ namespace sedaman {
 class ISEGD::Impl {
 public:
     Impl(CommonSEGD com);
-    unordered_map<string, Trace::Header::Value> read_trace_header();
+    void read_trace_header(unordered_map<string, Trace::Header::Value>& hdr);
+    void parse_trace_header(unordered_map<string, Trace::Header::Value>& hdr);
     void read_trace_header_ext
         (unordered_map<string, Trace::Header::Value>& hdr);
+    CommonSEGD::ChannelSetHeader& channel_set(unordered_map<string,
+                                              Trace::Header::Value>& hdr);
+    uint32_t samples_num(unordered_map<string, Trace::Header::Value>& hdr);
     vector<double> read_trace_samples(unordered_map<string,
 									  Trace::Header::Value>& hdr);
+    void read_trace_samples(unordered_map<string, Trace::Header::Value>& hdr,
+                            uint32_t samp_num, double* out);
+    bool trace_done();
     void read_headers_before_traces();
     void read_trailer();
     CommonSEGD common;
@@ -136,20 +143,91 @@ bool ISEGD::has_trace()
 
 Trace ISEGD::read_trace()
 {
-    unordered_map<string, Trace::Header::Value> hdr =
-	   	pimpl->read_trace_header();
+    unordered_map<string, Trace::Header::Value> hdr;
+    pimpl->read_trace_header(hdr);
     pimpl->read_trace_header_ext(hdr);
     vector<double> samples = pimpl->read_trace_samples(hdr);
-    ++pimpl->chans_read;
-    if (pimpl->chans_in_record == pimpl->chans_read) {
-        pimpl->chans_in_record = pimpl->chans_read = 0;
-        pimpl->common.channel_sets.clear();
-        if (has_record())
-            pimpl->read_headers_before_traces();
-    }
+    pimpl->trace_done();
     return Trace(move(hdr), move(samples));
 }
 
+ISEGD::Record ISEGD::read_record()
+{
+    if (!has_trace())
+        throw Exception(__FILE__, __LINE__, "no record to read");
+    Record rec;
+    // index of channel set in record by scan type and channel set numbers
+    map<pair<int64_t, int64_t>, size_t> sets;
+    // header map is reused, its values are bound to columns of table
+    unordered_map<string, Trace::Header::Value> hdr;
+    vector<pair<Trace::Header::Value const*, vector<Trace::Header::Value>*>>
+        bound;
+    int64_t bound_ext = -1;
+    uint64_t num = 0;
+    auto pad = [&rec, &num] {
+        for (auto& col : rec.headers)
+            col.second.resize(num, Trace::Header::Value(int64_t(0)));
+    };
+    bool last = false;
+    while (!last) {
+        pimpl->read_trace_header(hdr);
+        int64_t ext = get<int64_t>(hdr["TR_HDR_EXT"]);
+        // values of other trace header extensions are dropped
+        if (ext != bound_ext && bound_ext != -1) {
+            hdr.clear();
+            pimpl->parse_trace_header(hdr);
+        }
+        pimpl->read_trace_header_ext(hdr);
+        if (ext != bound_ext || hdr.size() != bound.size()) {
+            pad();
+            bound.clear();
+            for (auto& p : hdr)
+                bound.emplace_back(&p.second, &rec.headers[p.first]);
+            bound_ext = ext;
+            pad();
+        }
+        for (auto& b : bound)
+            b.second->push_back(*b.first);
+        auto key = std::make_pair(get<int64_t>(hdr["SCAN_TYPE_NUM"]),
+                                  get<int64_t>(hdr["CH_SET_NUM"]));
+        uint32_t samp_num = pimpl->samples_num(hdr);
+        auto it = sets.find(key);
+        if (it == sets.end()) {
+            it = sets.emplace(key, rec.channel_sets.size()).first;
+            Record::ChannelSet set { pimpl->channel_set(hdr), samp_num, {},
+                                     {} };
+            set.samples.reserve(static_cast<size_t>(samp_num) *
+                                set.header.number_of_channels);
+            set.traces.reserve(set.header.number_of_channels);
+            rec.channel_sets.push_back(move(set));
+        }
+        Record::ChannelSet& set = rec.channel_sets[it->second];
+        if (samp_num != set.samp_num)
+            throw Exception(__FILE__, __LINE__,
+                            "traces of channel set have different number of "
+                            "samples");
+        size_t row = set.samples.size();
+        set.samples.resize(row + samp_num);
+        pimpl->read_trace_samples(hdr, samp_num, set.samples.data() + row);
+        set.traces.push_back(num++);
+        last = pimpl->trace_done();
+    }
+    pad();
+    return rec;
+}
+
+bool ISEGD::Impl::trace_done()
+{
+    ++chans_read;
+    if (chans_in_record != chans_read)
+        return false;
+    chans_in_record = chans_read = 0;
+    common.channel_sets.clear();
+    if (curr_pos != end_of_data)
+        read_headers_before_traces();
+    return true;
+}
+
 ISEGD::Impl::Impl(CommonSEGD com)
     : common { move(com) }
 	, chans_in_record {0}
@@ -1235,10 +1313,16 @@ void ISEGD::Impl::check_trc_hdr_ext()
     }
 }
 
-unordered_map<string, Trace::Header::Value> ISEGD::Impl::read_trace_header()
+void ISEGD::Impl::read_trace_header(unordered_map<string,
+                                    Trace::Header::Value>& hdr)
 {
-    unordered_map<string, Trace::Header::Value> hdr;
     fill_buf_from_file(common.trc_hdr_buf, CommonSEGD::TRACE_HEADER_SIZE);
+    parse_trace_header(hdr);
+}
+
+void ISEGD::Impl::parse_trace_header(unordered_map<string,
+                                     Trace::Header::Value>& hdr)
+{
     char const* buf = common.trc_hdr_buf;
     hdr["FFID"] = from_bcd<uint32_t>(&buf, false, 4);
     hdr["SCAN_TYPE_NUM"] = from_bcd<uint16_t>(&buf, false, 2);
@@ -1257,8 +1341,6 @@ unordered_map<string, Trace::Header::Value> ISEGD::Impl::read_trace_header()
     uint32_t ext_file_num = read_u24(&buf);
     if (ext_file_num)
         hdr["FFID"] = ext_file_num;
-
-    return hdr;
 }
 
 void ISEGD::Impl::read_trace_header_ext(unordered_map<string,
@@ -1351,28 +1433,45 @@ void ISEGD::Impl::read_trace_header_ext(unordered_map<string,
     }
 }
 
+CommonSEGD::ChannelSetHeader& ISEGD::Impl::channel_set(unordered_map<string,
+                                                     Trace::Header::Value>& hdr)
+{
+    return common.channel_sets[get<int64_t>(hdr["SCAN_TYPE_NUM"]) - 1]
+		[get<int64_t>(hdr["CH_SET_NUM"]) - 1];
+}
+
+uint32_t ISEGD::Impl::samples_num(unordered_map<string,
+                                  Trace::Header::Value>& hdr)
+{
+    auto it = hdr.find("SAMP_NUM");
+    if (it != hdr.end())
+        return get<int64_t>(it->second);
+    CommonSEGD::ChannelSetHeader& curr_ch_set = channel_set(hdr);
+    if (curr_ch_set.number_of_samples())
+        return *curr_ch_set.number_of_samples();
+    return curr_ch_set.subscans_per_ch_set;
+}
+
 vector<double> ISEGD::Impl::read_trace_samples(unordered_map<string,
 											   Trace::Header::Value>& hdr)
 {
-    uint32_t samp_num;
-    CommonSEGD::ChannelSetHeader curr_ch_set =
-	   	common.channel_sets[get<int64_t>(hdr["SCAN_TYPE_NUM"]) - 1]
-		[get<int64_t>(hdr["CH_SET_NUM"]) - 1];
-    if (hdr.find("SAMP_NUM") != hdr.end())
-        samp_num = get<int64_t>(hdr["SAMP_NUM"]);
-    else if (curr_ch_set.number_of_samples())
-        samp_num = *curr_ch_set.number_of_samples();
-    else
-        samp_num = curr_ch_set.subscans_per_ch_set;
+    uint32_t samp_num = samples_num(hdr);
+    vector<double> result(samp_num);
+    read_trace_samples(hdr, samp_num, result.data());
+    return result;
+}
+
+void ISEGD::Impl::read_trace_samples(unordered_map<string,
+                                     Trace::Header::Value>& hdr,
+                                     uint32_t samp_num, double* out)
+{
     if (common.trc_samp_buf.size() != (samp_num * common.bits_per_sample) / 8)
         common.trc_samp_buf.resize((samp_num * common.bits_per_sample) / 8);
     fill_buf_from_file(common.trc_samp_buf.data(), common.trc_samp_buf.size());
     char const* buf = common.trc_samp_buf.data();
-    vector<double> result(samp_num);
-    double descale = pow(2, curr_ch_set.descale_multiplier);
+    double descale = pow(2, channel_set(hdr).descale_multiplier);
     for (uint32_t i = 0; i < samp_num; ++i)
-        result[i] = read_sample(&buf) * descale;
-    return result;
+        out[i] = read_sample(&buf) * descale;
 }
 
 void ISEGD::Impl::fill_buf_from_file(char* buf, streamsize n)
@@ -2,7 +2,9 @@
 #include "CommonSEGY.hpp"
 #include "Exception.hpp"
 #include "Trace.hpp"
+#include "ZStreambuf.hpp"
 #include "util.hpp"
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <cstdint>
@@ -11,19 +13,29 @@
 #include <ios>
 #include <string>
 #include <unordered_map>
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using std::fstream;
 using std::function;
 using std::get;
 using std::ios_base;
+using std::istream;
 using std::make_unique;
 using std::map;
+using std::min;
 using std::move;
+using std::optional;
 using std::pair;
 using std::streamoff;
 using std::streampos;
 using std::streamsize;
 using std::string;
+using std::unique_ptr;
 using std::unordered_map;
 using std::vector;
 
@@ -47,6 +59,17 @@ public:
         initialization(true);
     }
 
+    Impl(string name, Layout layout,
+        vector<pair<string, map<uint32_t, pair<string,
+	   	Trace::Header::ValueType>>>> hdr_map)
+        : common { move(name), fstream::in | fstream::binary,
+		   	move(layout.binary_header), move(hdr_map) }
+    {
+        initialization(move(layout));
+    }
+
+    // set for compressed file, common.file reads through it
+    unique_ptr<ZStreambuf> zbuf;
     CommonSEGY common;
     streampos first_trace_pos;
     streampos curr_pos;
@@ -55,11 +78,24 @@ public:
     function<vector<double>(unordered_map<string, Trace::Header::Value>&)>
 	   	read_trc_smpls;
     vector<double> read_trc_smpls_fix();
+    // IEEE samples in host byte order are read without per sample calls
+    bool native_ieee = false;
     vector<double> read_trc_smpls_var(unordered_map<string,
 									  Trace::Header::Value>& hdr);
+    void read_trc_smpls_raw(unordered_map<string, Trace::Header::Value>& hdr,
+							vector<char>& samples);
     void file_skip_bytes(streamoff off);
     vector<map<uint32_t, pair<string, Trace::Header::ValueType>>>
 	   	tr_hdr_default_io_map();
+    bool fixed_length();
+    uint32_t raw_headers_size();
+    streamoff trace_size();
+    uint64_t traces_count();
+    streampos trace_position(uint64_t num);
+    void read_raw_headers(function<void(unsigned, uint64_t, char const*)> f,
+						  unsigned threads);
+    unique_ptr<istream> open_file(bool buffered = true);
+    Layout layout();
 
 private:
     function<uint8_t(char const**)> read_u8;
@@ -77,6 +113,10 @@ private:
     function<double(char const** buf)> dbl_from_IEEE_float;
     function<double(char const** buf)> dbl_from_IEEE_double;
     void initialization(bool override_bin_hdr);
+    void initialization(Layout layout);
+    void open_compressed();
+    void assign_samples_per_trace();
+    void assign_trace_reader();
     void fill_bin_header(char const* buf, bool override_bin_hdr);
     void assign_raw_readers();
     void assign_sample_reader();
@@ -84,10 +124,161 @@ private:
     void assign_bytes_per_sample();
     void read_trailer_stanzas();
     void fill_buf_from_file(char* buf, streamsize n);
+    void index_traces();
+    vector<streampos> trc_index;
+    bool indexed = false;
+
+public:
+    // walking through variable length traces to find trailer stanzas is
+    // deferred until they or end of data are needed
+    bool trailer_read = false;
+    // ordinal number of trace at current position
+    uint64_t curr_trc = 0;
+    void ensure_trailer();
+    void read_trailer_at(streampos pos);
 };
 
+// Writes new file from byte ranges of source file. On Linux ranges are
+// copied by copy_file_range, so data do not pass through user space; read
+// and write through buffer are used if it is not possible.
+class RangeCopier {
+public:
+    RangeCopier(string const& src, unique_ptr<istream> in, bool plain,
+                string const& dst);
+    ~RangeCopier();
+    void write(char const* buf, size_t n);
+    void copy(uint64_t pos, uint64_t n);
+
+private:
+    unique_ptr<istream> in;
+    vector<char> buf;
+#ifdef __linux__
+    int in_fd = -1;
+    int out_fd = -1;
+    bool in_kernel = true;
+    [[noreturn]] void fail(string const& what);
+#else
+    std::ofstream out;
+#endif
+};
+
+#ifdef __linux__
+RangeCopier::RangeCopier(string const& src, unique_ptr<istream> s,
+                         bool plain, string const& dst)
+    : in { move(s) }
+{
+    if (plain) {
+        in_fd = ::open(src.c_str(), O_RDONLY);
+        if (in_fd < 0)
+            fail("unable to open " + src);
+    }
+    out_fd = ::open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (out_fd < 0) {
+        // destructor is not called when constructor throws
+        int err = errno;
+        if (in_fd >= 0)
+            ::close(in_fd);
+        errno = err;
+        fail("unable to open " + dst);
+    }
+}
+
+RangeCopier::~RangeCopier()
+{
+    if (in_fd >= 0)
+        ::close(in_fd);
+    if (out_fd >= 0)
+        ::close(out_fd);
+}
+
+void RangeCopier::fail(string const& what)
+{
+    throw Exception(__FILE__, __LINE__, what + ": " + std::strerror(errno));
+}
+
+void RangeCopier::write(char const* b, size_t n)
+{
+    while (n) {
+        ssize_t done = ::write(out_fd, b, n);
+        if (done < 0) {
+            if (errno == EINTR)
+                continue;
+            fail("write failed");
+        }
+        b += done;
+        n -= done;
+    }
+}
+
+void RangeCopier::copy(uint64_t pos, uint64_t n)
+{
+    while (in_fd >= 0 && in_kernel && n) {
+        loff_t off = pos;
+        ssize_t done = ::copy_file_range(in_fd, &off, out_fd, nullptr, n, 0);
+        if (done < 0) {
+            if (errno == EINTR)
+                continue;
+            // not supported by kernel or file systems
+            if (errno != EXDEV && errno != ENOSYS && errno != EINVAL &&
+                errno != EOPNOTSUPP)
+                fail("copy_file_range failed");
+            in_kernel = false;
+            break;
+        }
+        if (!done)
+            throw Exception(__FILE__, __LINE__, "unexpected end of file");
+        pos += done;
+        n -= done;
+    }
+    if (!n)
+        return;
+    buf.resize(1 << 20);
+    in->seekg(pos);
+    while (n) {
+        size_t part = min<uint64_t>(n, buf.size());
+        in->read(buf.data(), part);
+        write(buf.data(), part);
+        n -= part;
+    }
+}
+#else
+RangeCopier::RangeCopier(string const&, unique_ptr<istream> s, bool,
+                         string const& dst)
+    : in { move(s) }
+{
+    out.exceptions(fstream::failbit | fstream::badbit);
+    out.open(dst, fstream::binary);
+}
+
+RangeCopier::~RangeCopier() = default;
+
+void RangeCopier::write(char const* b, size_t n) { out.write(b, n); }
+
+void RangeCopier::copy(uint64_t pos, uint64_t n)
+{
+    buf.resize(1 << 20);
+    in->seekg(pos);
+    while (n) {
+        size_t part = min<uint64_t>(n, buf.size());
+        in->read(buf.data(), part);
+        out.write(buf.data(), part);
+        n -= part;
+    }
+}
+#endif
+
+void ISEGY::Impl::open_compressed()
+{
+    if (ZStreambuf::is_compressed(common.file_name)) {
+        zbuf = make_unique<ZStreambuf>(common.file_name);
+        common.file.close();
+        static_cast<std::ios&>(common.file).rdbuf(zbuf.get());
+    }
+}
+
 void ISEGY::Impl::initialization(bool override_bin_hdr)
 {
+    open_compressed();
     char text_buf[CommonSEGY::TEXT_HEADER_SIZE];
     common.file.read(text_buf, CommonSEGY::TEXT_HEADER_SIZE);
     common.text_headers.emplace_back(text_buf, CommonSEGY::TEXT_HEADER_SIZE);
@@ -106,14 +297,48 @@ void ISEGY::Impl::initialization(bool override_bin_hdr)
     } else {
         first_trace_pos = common.file.tellg();
     }
+    assign_samples_per_trace();
+	if (common.binary_header.num_of_trailer_stanza != -1 || fixed_length())
+		read_trailer_stanzas();
+	else if (!common.binary_header.num_of_tr_in_file)
+		throw Exception(__FILE__, __LINE__,
+						"unable to determine end of trace data");
+    common.file.seekg(first_trace_pos);
+    curr_pos = first_trace_pos;
+    assign_trace_reader();
+}
+
+// everything is taken from layout, file is only opened
+void ISEGY::Impl::initialization(Layout layout)
+{
+    open_compressed();
+    common.text_headers = move(layout.text_headers);
+    common.trailer_stanzas = move(layout.trailer_stanzas);
+    assign_raw_readers();
+    assign_sample_reader();
+    assign_bytes_per_sample();
+    assign_samples_per_trace();
+    first_trace_pos = layout.first_trace;
+    end_of_data = layout.end_of_data;
+    trailer_read = true;
+    trc_index = move(layout.traces);
+    indexed = true;
+    common.file.seekg(first_trace_pos);
+    curr_pos = first_trace_pos;
+    assign_trace_reader();
+}
+
+void ISEGY::Impl::assign_samples_per_trace()
+{
     common.samp_per_tr = common.binary_header.ext_samp_per_tr ?
 	   	common.binary_header.ext_samp_per_tr :
 		/* static cast for the case you will get SEGY prior rev2 with samples
 		 * more then int16_t can hold without wrap. i got one */
 	   	static_cast<uint16_t>(common.binary_header.samp_per_tr);
-    read_trailer_stanzas();
-    common.file.seekg(first_trace_pos);
-    curr_pos = first_trace_pos;
+}
+
+void ISEGY::Impl::assign_trace_reader()
+{
     common.samp_buf.resize(static_cast<decltype(common.samp_buf.size())>(
         common.samp_per_tr * common.bytes_per_sample));
 	if (common.binary_header.fixed_tr_length ||
@@ -147,52 +372,7 @@ void ISEGY::Impl::fill_bin_header(char const* buf, bool override_bin_hdr)
     assign_raw_readers();
     if (override_bin_hdr)
 		return;
-    common.binary_header.job_id = read_i32(&buf);
-    common.binary_header.line_num = read_i32(&buf);
-    common.binary_header.reel_num = read_i32(&buf);
-    common.binary_header.tr_per_ens = read_i16(&buf);
-    common.binary_header.aux_per_ens = read_i16(&buf);
-    common.binary_header.samp_int = read_i16(&buf);
-    common.binary_header.samp_int_orig = read_i16(&buf);
-    common.binary_header.samp_per_tr = read_i16(&buf);
-    common.binary_header.samp_per_tr_orig = read_i16(&buf);
-    common.binary_header.format_code = read_i16(&buf);
-    common.binary_header.ens_fold = read_i16(&buf);
-    common.binary_header.sort_code = read_i16(&buf);
-    common.binary_header.vert_sum_code = read_i16(&buf);
-    common.binary_header.sw_freq_at_start = read_i16(&buf);
-    common.binary_header.sw_freq_at_end = read_i16(&buf);
-    common.binary_header.sw_length = read_i16(&buf);
-    common.binary_header.sw_type_code = read_i16(&buf);
-    common.binary_header.sw_ch_tr_num = read_i16(&buf);
-    common.binary_header.taper_at_start = read_i16(&buf);
-    common.binary_header.taper_at_end = read_i16(&buf);
-    common.binary_header.taper_type = read_i16(&buf);
-    common.binary_header.corr_traces = read_i16(&buf);
-    common.binary_header.bin_gain_recov = read_i16(&buf);
-    common.binary_header.amp_recov_meth = read_i16(&buf);
-    common.binary_header.measure_system = read_i16(&buf);
-    common.binary_header.impulse_sig_pol = read_i16(&buf);
-    common.binary_header.vib_pol_code = read_i16(&buf);
-    common.binary_header.ext_tr_per_ens = read_i32(&buf);
-    common.binary_header.ext_aux_per_ens = read_i32(&buf);
-    common.binary_header.ext_samp_per_tr = read_i32(&buf);
-    common.binary_header.ext_samp_int = dbl_from_IEEE_double(&buf);
-    common.binary_header.ext_samp_int_orig = dbl_from_IEEE_double(&buf);
-    common.binary_header.ext_samp_per_tr_orig = read_i32(&buf);
-    common.binary_header.ext_ens_fold = read_i32(&buf);
-    buf += 204; // skip unassigned fields and endianness
-    common.binary_header.SEGY_rev_major_ver = read_u8(&buf);
-    common.binary_header.SEGY_rev_minor_ver = read_u8(&buf);
-    common.binary_header.fixed_tr_length = read_i16(&buf);
-    common.binary_header.ext_text_headers_num = read_i16(&buf);
-	if (common.binary_header.SEGY_rev_major_ver > 1) {
-		common.binary_header.max_num_add_tr_headers = read_i32(&buf);
-		common.binary_header.time_basis_code = read_i16(&buf);
-		common.binary_header.num_of_tr_in_file = read_i64(&buf);
-		common.binary_header.byte_off_of_first_tr = read_u64(&buf);
-		common.binary_header.num_of_trailer_stanza = read_i32(&buf);
-	}
+    common.binary_header = CommonSEGY::parse_binary_header(buf);
 }
 
 void ISEGY::Impl::assign_raw_readers()
@@ -200,7 +380,7 @@ void ISEGY::Impl::assign_raw_readers()
     read_u8 = [](char const** buf) { return read<uint8_t>(buf); };
     read_i8 = [](char const** buf) { return read<int8_t>(buf); };
     switch (common.binary_header.endianness) {
-    case 0x01020304:
+    case CommonSEGY::NATIVE_ENDIANNESS:
         read_u16 = [](char const** buf) { return read<uint16_t>(buf); };
         read_i16 = [](char const** buf) { return read<int16_t>(buf); };
         read_u24 = [](char const** buf) { return read<uint16_t>(buf) |
@@ -317,6 +497,10 @@ void ISEGY::Impl::assign_sample_reader()
     default:
         throw(Exception(__FILE__, __LINE__, "unsupported format"));
     }
+    native_ieee = FLT_RADIX == 2 && DBL_MANT_DIG == 53 &&
+        common.binary_header.endianness == CommonSEGY::NATIVE_ENDIANNESS &&
+        (common.binary_header.format_code == 5 ||
+         common.binary_header.format_code == 6);
 }
 
 void ISEGY::Impl::read_ext_text_headers()
@@ -351,62 +535,15 @@ void ISEGY::Impl::read_trailer_stanzas()
         if (!common.binary_header.num_of_tr_in_file)
             throw(Exception(__FILE__, __LINE__,
 						   	"unable to determine end of trace data"));
-        if (common.binary_header.fixed_tr_length) {
-            // skip all traces
-            common.file.seekg(common.bytes_per_sample * common.samp_per_tr *
-							  common.binary_header.num_of_tr_in_file,
-							  ios_base::cur);
-            end_of_data = common.file.tellg();
-            string end_stanza = "((SEG: EndText))";
-            while (1) {
-                common.file.read(text_buf, CommonSEGY::TEXT_HEADER_SIZE);
-                common.trailer_stanzas
-					.emplace_back(text_buf,	CommonSEGY::TEXT_HEADER_SIZE);
-                if (!end_stanza.compare(0, end_stanza.size(), text_buf,
-									   	end_stanza.size()))
-                    return;
-            }
-        } else {
-            // variable trace length
-            char trc_hdr_buf[CommonSEGY::TR_HEADER_SIZE];
-            for (auto i = common.binary_header.num_of_tr_in_file; i; --i) {
-                common.file.read(trc_hdr_buf, CommonSEGY::TR_HEADER_SIZE);
-                // get number of samples from main header
-                char const* ptr = trc_hdr_buf + 114;
-                uint32_t trc_samp_num = read_i16(&ptr);
-                if (common.binary_header.max_num_add_tr_headers) {
-                    // if there are additional header(s)
-                    // get number of samples from first additional header
-                    common.file.read(trc_hdr_buf, CommonSEGY::TR_HEADER_SIZE);
-                    ptr = trc_hdr_buf + 136;
-                    trc_samp_num = read_u32(&ptr);
-                    ptr = trc_hdr_buf + 156;
-                    uint16_t add_tr_hdr_num = read_u16(&ptr);
-                    add_tr_hdr_num = add_tr_hdr_num ? add_tr_hdr_num :
-					   	common.binary_header.max_num_add_tr_headers;
-                    // skip addional headers
-                    common.file.seekg((add_tr_hdr_num - 1) *
-									  CommonSEGY::TR_HEADER_SIZE,
-									  ios_base::cur);
-                }
-                // skip trace samples
-                common.file.seekg(trc_samp_num * common.bytes_per_sample,
-								  ios_base::cur);
-            }
-            end_of_data = common.file.tellg();
-            string end_stanza = "((SEG: EndText))";
-            while (1) {
-                common.file.read(text_buf, CommonSEGY::TEXT_HEADER_SIZE);
-                common.trailer_stanzas
-					.emplace_back(text_buf, CommonSEGY::TEXT_HEADER_SIZE);
-                if (!end_stanza.compare(0, end_stanza.size(), text_buf,
-									   	end_stanza.size()))
-                    return;
-            }
-        }
+        // skip all traces, variable length traces are walked through
+        // later in index_traces
+        read_trailer_at(common.file.tellg() + trace_size() *
+						static_cast<streamoff>(
+							common.binary_header.num_of_tr_in_file));
     } else {
         // go to first trailer stanza
-        common.file.seekg(common.binary_header.num_of_trailer_stanza *
+        common.file.seekg(-static_cast<streamoff>(
+							  common.binary_header.num_of_trailer_stanza) *
 						  CommonSEGY::TEXT_HEADER_SIZE, ios_base::end);
         end_of_data = common.file.tellg();
         for (int32_t i = common.binary_header.num_of_trailer_stanza; i; --i) {
@@ -414,6 +551,34 @@ void ISEGY::Impl::read_trailer_stanzas()
             common.trailer_stanzas.emplace_back(text_buf,
 											   	CommonSEGY::TEXT_HEADER_SIZE);
         }
+        trailer_read = true;
+    }
+}
+
+void ISEGY::Impl::read_trailer_at(streampos pos)
+{
+    char text_buf[CommonSEGY::TEXT_HEADER_SIZE];
+    end_of_data = pos;
+    common.file.seekg(pos);
+    string end_stanza = "((SEG: EndText))";
+    while (1) {
+        common.file.read(text_buf, CommonSEGY::TEXT_HEADER_SIZE);
+        common.trailer_stanzas.emplace_back(text_buf,
+											CommonSEGY::TEXT_HEADER_SIZE);
+        if (!end_stanza.compare(0, end_stanza.size(), text_buf,
+							   	end_stanza.size()))
+            break;
+    }
+    trailer_read = true;
+}
+
+void ISEGY::Impl::ensure_trailer()
+{
+    if (!trailer_read) {
+        // trailer is read through common.file, position is kept
+        streampos pos = common.file.tellg();
+        index_traces();
+        common.file.seekg(pos);
     }
 }
 
@@ -506,9 +671,134 @@ unordered_map<string, Trace::Header::Value> ISEGY::Impl::read_trc_header()
     return hdr;
 }
 
+bool ISEGY::Impl::fixed_length()
+{
+	return common.binary_header.fixed_tr_length ||
+		common.binary_header.SEGY_rev_major_ver == 0;
+}
+
+uint32_t ISEGY::Impl::raw_headers_size()
+{
+	return CommonSEGY::TR_HEADER_SIZE *
+		(common.binary_header.max_num_add_tr_headers + 1);
+}
+
+streamoff ISEGY::Impl::trace_size()
+{
+	return raw_headers_size() +
+		static_cast<streamoff>(common.samp_per_tr) * common.bytes_per_sample;
+}
+
+unique_ptr<istream> ISEGY::Impl::open_file(bool buffered)
+{
+	if (zbuf) {
+		// shares seek points found so far
+		unique_ptr<istream> fl = make_unique<ZIStream>(zbuf->clone());
+		fl->exceptions(fstream::failbit | fstream::badbit);
+		return fl;
+	}
+	auto fl = make_unique<fstream>();
+	if (!buffered)
+		fl->rdbuf()->pubsetbuf(nullptr, 0);
+	fl->exceptions(fstream::failbit | fstream::badbit);
+	fl->open(common.file_name, fstream::in | fstream::binary);
+	return fl;
+}
+
+void ISEGY::Impl::index_traces()
+{
+	if (indexed)
+		return;
+	unique_ptr<istream> fl = open_file();
+	vector<char> buf(raw_headers_size());
+	streampos pos = first_trace_pos;
+	// without known end of data number of traces is taken from binary header
+	while (trailer_read ? pos < end_of_data :
+		   trc_index.size() < common.binary_header.num_of_tr_in_file) {
+		trc_index.push_back(pos);
+		fl->seekg(pos);
+		fl->read(buf.data(), buf.size());
+		// get number of samples from main header
+		char const* ptr = buf.data() + 114;
+		uint64_t samp_num = read_u16(&ptr);
+		if (common.binary_header.max_num_add_tr_headers) {
+			// from first additional header if there is one
+			ptr = buf.data() + CommonSEGY::TR_HEADER_SIZE + 136;
+			samp_num = read_u32(&ptr);
+		}
+		pos += static_cast<streamoff>(buf.size() +
+									  samp_num * common.bytes_per_sample);
+	}
+	if (!trailer_read) {
+		streampos saved = common.file.tellg();
+		read_trailer_at(pos);
+		common.file.seekg(saved);
+	}
+	indexed = true;
+}
+
+ISEGY::Layout ISEGY::Impl::layout()
+{
+	ensure_trailer();
+	if (!fixed_length())
+		index_traces();
+	return { common.text_headers, common.binary_header,
+			 common.trailer_stanzas, first_trace_pos, end_of_data,
+			 trc_index };
+}
+
+uint64_t ISEGY::Impl::traces_count()
+{
+	if (fixed_length())
+		return (end_of_data - first_trace_pos) / trace_size();
+	index_traces();
+	return trc_index.size();
+}
+
+streampos ISEGY::Impl::trace_position(uint64_t num)
+{
+	if (num >= traces_count())
+		throw Exception(__FILE__, __LINE__, "no such trace in file");
+	if (fixed_length())
+		return first_trace_pos + static_cast<streamoff>(num) * trace_size();
+	return trc_index[num];
+}
+
+void ISEGY::Impl::read_raw_headers(function<void(unsigned, uint64_t,
+												 char const*)> func,
+								   unsigned threads)
+{
+	uint64_t num = traces_count();
+	uint32_t hdrs_size = raw_headers_size();
+	streamoff trc_size = fixed_length() ? trace_size() : 0;
+	parallel_for(num, threads, [&](unsigned thr, uint64_t from, uint64_t to) {
+		unique_ptr<istream> fl = open_file();
+		if (trc_size && trc_size - hdrs_size <= 64 * 1024) {
+			// short traces, one big read is cheaper than seek for each
+			uint64_t blk = std::max<uint64_t>(1, (4 << 20) / trc_size);
+			vector<char> buf(blk * trc_size);
+			fl->seekg(trace_position(from));
+			for (uint64_t i = from; i < to; i += blk) {
+				uint64_t n = min(blk, to - i);
+				fl->read(buf.data(), n * trc_size);
+				for (uint64_t k = 0; k < n; ++k)
+					func(thr, i + k, buf.data() + k * trc_size);
+			}
+		} else {
+			vector<char> buf(hdrs_size);
+			for (uint64_t i = from; i < to; ++i) {
+				fl->seekg(trace_position(i));
+				fl->read(buf.data(), hdrs_size);
+				func(thr, i, buf.data());
+			}
+		}
+	});
+}
+
 Trace::Header ISEGY::read_header()
 {
     unordered_map<string, Trace::Header::Value> hdr = pimpl->read_trc_header();
+    ++pimpl->curr_trc;
     if (pimpl->common.binary_header.fixed_tr_length ||
 	   	pimpl->common.binary_header.SEGY_rev_major_ver == 0) {
         pimpl->file_skip_bytes(pimpl->common.samp_per_tr *
@@ -526,6 +816,12 @@ vector<double> ISEGY::Impl::read_trc_smpls_fix()
     fill_buf_from_file(common.samp_buf.data(), common.samp_buf.size());
     char const* buf = common.samp_buf.data();
     vector<double> result(common.samp_buf.size() / common.bytes_per_sample);
+    if (native_ieee) {
+        CommonSEGY::read_samples(buf, result.data(), result.size(),
+                                 common.binary_header.format_code,
+                                 common.binary_header.endianness);
+        return result;
+    }
     for (decltype(result.size()) i = 0; i < result.size(); ++i)
         result[i] = read_sample(&buf);
     return result;
@@ -541,15 +837,41 @@ vector<double> ISEGY::Impl::read_trc_smpls_var(unordered_map<string,
     return read_trc_smpls_fix();
 }
 
+void ISEGY::Impl::read_trc_smpls_raw(unordered_map<string,
+									 Trace::Header::Value>& hdr,
+									 vector<char>& samples)
+{
+    size_t samp_num = fixed_length() ? common.samp_per_tr :
+        get<int64_t>(hdr["SAMP_NUM"]);
+    samples.resize(samp_num * common.bytes_per_sample);
+    fill_buf_from_file(samples.data(), samples.size());
+}
+
 Trace ISEGY::read_trace()
 {
     unordered_map<string, Trace::Header::Value> hdr = pimpl->read_trc_header();
     vector<double> samples = pimpl->read_trc_smpls(hdr);
+    ++pimpl->curr_trc;
     return Trace(move(hdr), move(samples));
 }
 
+Trace::Header ISEGY::read_raw_trace(vector<char>& samples)
+{
+    unordered_map<string, Trace::Header::Value> hdr = pimpl->read_trc_header();
+    pimpl->read_trc_smpls_raw(hdr, samples);
+    ++pimpl->curr_trc;
+    return Trace::Header(move(hdr));
+}
+
 bool ISEGY::has_trace()
 {
+    if (!pimpl->trailer_read) {
+        if (pimpl->curr_trc < pimpl->common.binary_header.num_of_tr_in_file)
+            return true;
+        // all traces are read, trailer stanzas follow them
+        pimpl->read_trailer_at(pimpl->curr_pos);
+        pimpl->common.file.seekg(pimpl->curr_pos);
+    }
     if (pimpl->curr_pos == pimpl->end_of_data)
         return false;
     else
@@ -563,6 +885,7 @@ vector<string> const& ISEGY::text_headers()
 
 vector<string> const& ISEGY::trailer_stanzas()
 {
+    pimpl->ensure_trailer();
     return pimpl->common.trailer_stanzas;
 }
 
@@ -584,10 +907,110 @@ ISEGY::ISEGY(string name, CommonSEGY::BinaryHeader bh,
 {
 }
 
+ISEGY::ISEGY(string name, Layout layout, vector<pair<string,
+    map<uint32_t, pair<string, Trace::Header::ValueType>>>> hdr_map)
+	: pimpl { make_unique<Impl>(move(name), move(layout), move(hdr_map)) }
+{
+}
+
 CommonSEGY::BinaryHeader ISEGY::read_binary_header(std::string file_name)
 {
-    ISEGY s(file_name);
-    return s.binary_header();
+    char buf[CommonSEGY::BIN_HEADER_SIZE];
+    if (ZStreambuf::is_compressed(file_name)) {
+        ZIStream fl(make_unique<ZStreambuf>(file_name));
+        fl.exceptions(fstream::failbit | fstream::badbit);
+        fl.seekg(CommonSEGY::TEXT_HEADER_SIZE);
+        fl.read(buf, CommonSEGY::BIN_HEADER_SIZE);
+        return CommonSEGY::parse_binary_header(buf);
+    }
+    fstream fl;
+    fl.exceptions(fstream::failbit | fstream::badbit);
+    fl.open(file_name, fstream::in | fstream::binary);
+    fl.seekg(CommonSEGY::TEXT_HEADER_SIZE);
+    fl.read(buf, CommonSEGY::BIN_HEADER_SIZE);
+    return CommonSEGY::parse_binary_header(buf);
+}
+
+uint64_t ISEGY::traces_count() { return pimpl->traces_count(); }
+
+ISEGY::Layout ISEGY::layout() { return pimpl->layout(); }
+
+streampos ISEGY::trace_position(uint64_t num)
+{
+	return pimpl->trace_position(num);
+}
+
+void ISEGY::seek_trace(uint64_t num)
+{
+	pimpl->common.file.seekg(pimpl->trace_position(num));
+	pimpl->curr_pos = pimpl->common.file.tellg();
+	pimpl->curr_trc = num;
+}
+
+void ISEGY::extract_traces(string const& file_name,
+						   vector<uint64_t> const& traces)
+{
+	pimpl->ensure_trailer();
+	uint64_t count = pimpl->traces_count();
+	// consecutive traces are merged into one range
+	vector<pair<streamoff, streamoff>> ranges;
+	for (uint64_t num : traces) {
+		streamoff from = pimpl->trace_position(num);
+		streamoff to = num + 1 < count ? pimpl->trace_position(num + 1) :
+			pimpl->end_of_data;
+		if (!ranges.empty() &&
+			ranges.back().first + ranges.back().second == from)
+			ranges.back().second += to - from;
+		else
+			ranges.emplace_back(from, to - from);
+	}
+	// text and binary headers are copied as they are, only number of
+	// traces is changed
+	unique_ptr<istream> fl = pimpl->open_file(false);
+	vector<char> head(static_cast<uint64_t>(pimpl->first_trace_pos));
+	fl->seekg(0);
+	fl->read(head.data(), head.size());
+	char* bin = head.data() + CommonSEGY::TEXT_HEADER_SIZE;
+	CommonSEGY::BinaryHeader bh = CommonSEGY::parse_binary_header(bin);
+	if (bh.SEGY_rev_major_ver > 1) {
+		bh.num_of_tr_in_file = traces.size();
+		CommonSEGY::format_binary_header(bh, bin);
+	}
+	RangeCopier out(pimpl->common.file_name, move(fl), !pimpl->zbuf,
+					file_name);
+	out.write(head.data(), head.size());
+	for (auto& r : ranges)
+		out.copy(r.first, r.second);
+	for (string const& s : pimpl->common.trailer_stanzas)
+		out.write(s.data(), s.size());
+}
+
+uint32_t ISEGY::raw_headers_size() { return pimpl->raw_headers_size(); }
+
+unique_ptr<istream> ISEGY::open_stream(bool buffered)
+{
+	return pimpl->open_file(buffered);
+}
+
+optional<pair<uint32_t, Trace::Header::ValueType>>
+ISEGY::raw_header_offset(string const& name)
+{
+	optional<pair<uint32_t, Trace::Header::ValueType>> result;
+	auto& hdr_map = pimpl->common.tr_hdr_map;
+	for (decltype(hdr_map.size()) i = 0; i < hdr_map.size() &&
+		 i <= static_cast<decltype(i)>(
+			 pimpl->common.binary_header.max_num_add_tr_headers); ++i)
+		for (auto& p : hdr_map[i].second)
+			if (p.second.first == name)
+				result = pair<uint32_t, Trace::Header::ValueType>(
+					i * CommonSEGY::TR_HEADER_SIZE + p.first, p.second.second);
+	return result;
+}
+
+void ISEGY::read_raw_headers(function<void(unsigned, uint64_t, char const*)>
+							 func, unsigned threads)
+{
+	pimpl->read_raw_headers(move(func), threads);
 }
 
 CommonSEGY& ISEGY::common()
@@ -0,0 +1,237 @@
+#include "ISEGY3D.hpp"
+#include "Exception.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <variant>
+
+using std::gcd;
+using std::holds_alternative;
+using std::llround;
+using std::make_unique;
+using std::map;
+using std::move;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace sedaman {
+class ISEGY3D::Impl {
+public:
+    Impl(ISEGY3D &s, string il_name, string xl_name);
+    Grid grid;
+    uint32_t samp_num;
+    // trace number + 1 for every grid node, 0 for missing traces
+    vector<uint64_t> nodes;
+    uint64_t node(int64_t il, int64_t xl);
+    vector<double> read_samples(vector<uint64_t> const &trcs, uint32_t first,
+                                uint32_t num);
+    Cube read_cube(unsigned threads);
+
+private:
+    ISEGY3D &sgy;
+};
+
+static int64_t as_int(Trace::Header::Value v) {
+    return holds_alternative<int64_t>(v) ? std::get<int64_t>(v)
+                                         : llround(std::get<double>(v));
+}
+
+static void fit_axis(vector<int64_t> v, int64_t &first, int64_t &step,
+                     uint64_t &num) {
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+    first = v.front();
+    step = 0;
+    for (size_t i = 1; i < v.size(); ++i)
+        step = gcd(step, v[i] - v[i - 1]);
+    if (!step)
+        step = 1;
+    num = (v.back() - first) / step + 1;
+}
+
+ISEGY3D::Impl::Impl(ISEGY3D &s, string il_name, string xl_name) : sgy{s} {
+    auto il_off = s.raw_header_offset(il_name);
+    auto xl_off = s.raw_header_offset(xl_name);
+    if (!il_off || !xl_off)
+        throw Exception(__FILE__, __LINE__, "no such header in trace");
+    CommonSEGY::BinaryHeader const &bh = s.binary_header();
+    samp_num = s.common().samp_per_tr;
+    // for traces with variable length check that all of them are equal
+    auto sn_off = bh.fixed_tr_length || !bh.SEGY_rev_major_ver
+                      ? std::nullopt
+                      : s.raw_header_offset("SAMP_NUM");
+    uint64_t trc_num = s.traces_count();
+    if (!trc_num)
+        throw Exception(__FILE__, __LINE__, "there are no traces in file");
+    vector<int64_t> ils(trc_num), xls(trc_num);
+    s.read_raw_headers([&](unsigned, uint64_t i, char const *hdr) {
+        ils[i] = as_int(CommonSEGY::read_header_value(
+            hdr + il_off->first, il_off->second, bh.endianness));
+        xls[i] = as_int(CommonSEGY::read_header_value(
+            hdr + xl_off->first, xl_off->second, bh.endianness));
+        if (sn_off && as_int(CommonSEGY::read_header_value(
+                          hdr + sn_off->first, sn_off->second,
+                          bh.endianness)) != static_cast<int64_t>(samp_num))
+            throw Exception(__FILE__, __LINE__,
+                            "traces in volume have different length");
+    });
+    fit_axis(ils, grid.il_first, grid.il_step, grid.il_num);
+    fit_axis(xls, grid.xl_first, grid.xl_step, grid.xl_num);
+    nodes.resize(grid.il_num * grid.xl_num);
+    for (uint64_t i = 0; i < trc_num; ++i) {
+        uint64_t &n = nodes[node(ils[i], xls[i])];
+        if (n)
+            throw Exception(__FILE__, __LINE__,
+                            "several traces with the same inline and "
+                            "crossline");
+        n = i + 1;
+    }
+    grid.missing = std::count(nodes.begin(), nodes.end(), 0);
+}
+
+uint64_t ISEGY3D::Impl::node(int64_t il, int64_t xl) {
+    int64_t il_idx = (il - grid.il_first) / grid.il_step;
+    int64_t xl_idx = (xl - grid.xl_first) / grid.xl_step;
+    if ((il - grid.il_first) % grid.il_step ||
+        (xl - grid.xl_first) % grid.xl_step || il_idx < 0 || xl_idx < 0 ||
+        static_cast<uint64_t>(il_idx) >= grid.il_num ||
+        static_cast<uint64_t>(xl_idx) >= grid.xl_num)
+        throw Exception(__FILE__, __LINE__,
+                        "inline and crossline are out of grid");
+    return il_idx * grid.xl_num + xl_idx;
+}
+
+vector<double> ISEGY3D::Impl::read_samples(vector<uint64_t> const &trcs,
+                                           uint32_t first, uint32_t num) {
+    vector<double> result(trcs.size() * num);
+    CommonSEGY::BinaryHeader const &bh = sgy.binary_header();
+    int bps = sgy.common().bytes_per_sample;
+    std::streamoff skip = sgy.raw_headers_size() +
+                          static_cast<std::streamoff>(first) * bps;
+    parallel_for(trcs.size(), 0, [&](unsigned, uint64_t from, uint64_t to) {
+        // no buffering, only needed bytes are read for every trace
+        std::unique_ptr<std::istream> fl = sgy.open_stream(false);
+        vector<char> buf(static_cast<size_t>(num) * bps);
+        for (uint64_t i = from; i < to; ++i) {
+            if (!trcs[i])
+                continue;
+            fl->seekg(sgy.trace_position(trcs[i] - 1) + skip);
+            fl->read(buf.data(), buf.size());
+            CommonSEGY::read_samples(buf.data(), result.data() + i * num, num,
+                                     bh.format_code, bh.endianness);
+        }
+    });
+    return result;
+}
+
+ISEGY3D::Cube ISEGY3D::Impl::read_cube(unsigned threads) {
+    Cube cube;
+    cube.grid = grid;
+    cube.samp_num = samp_num;
+    cube.samples.resize(nodes.size() * samp_num);
+    cube.mask.resize(nodes.size());
+    // grid node for every trace in file order
+    vector<uint64_t> trc_nodes(nodes.size() - grid.missing);
+    for (uint64_t i = 0; i < nodes.size(); ++i)
+        if (nodes[i])
+            trc_nodes[nodes[i] - 1] = i;
+    CommonSEGY::BinaryHeader const &bh = sgy.binary_header();
+    auto id_off = sgy.raw_header_offset("TRACE_ID");
+    uint32_t hdrs_size = sgy.raw_headers_size();
+    uint64_t trc_size = hdrs_size + static_cast<uint64_t>(samp_num) *
+                                        sgy.common().bytes_per_sample;
+    uint64_t blk = std::max<uint64_t>(1, (4 << 20) / trc_size);
+    parallel_for(trc_nodes.size(), threads,
+                 [&](unsigned, uint64_t from, uint64_t to) {
+        std::unique_ptr<std::istream> fl = sgy.open_stream();
+        vector<char> buf(blk * trc_size);
+        // all traces have the same length, so they follow one another
+        fl->seekg(sgy.trace_position(from));
+        for (uint64_t i = from; i < to; i += blk) {
+            uint64_t n = std::min(blk, to - i);
+            fl->read(buf.data(), n * trc_size);
+            for (uint64_t k = 0; k < n; ++k) {
+                char const *trc = buf.data() + k * trc_size;
+                uint64_t node = trc_nodes[i + k];
+                if (id_off && as_int(CommonSEGY::read_header_value(
+                                  trc + id_off->first, id_off->second,
+                                  bh.endianness)) == 2)
+                    continue;
+                cube.mask[node] = 1;
+                CommonSEGY::read_samples(trc + hdrs_size,
+                                         cube.samples.data() +
+                                             node * samp_num,
+                                         samp_num, bh.format_code,
+                                         bh.endianness);
+            }
+        }
+    });
+    return cube;
+}
+
+ISEGY3D::Grid const &ISEGY3D::grid() { return pimpl->grid; }
+
+uint32_t ISEGY3D::samples_per_trace() { return pimpl->samp_num; }
+
+bool ISEGY3D::trace_exists(int64_t il, int64_t xl) {
+    return pimpl->nodes[pimpl->node(il, xl)];
+}
+
+std::optional<uint64_t> ISEGY3D::trace_number(int64_t il, int64_t xl) {
+    uint64_t n = pimpl->nodes[pimpl->node(il, xl)];
+    return n ? std::optional<uint64_t>(n - 1) : std::nullopt;
+}
+
+Trace ISEGY3D::get_trace(int64_t il, int64_t xl) {
+    uint64_t n = pimpl->nodes[pimpl->node(il, xl)];
+    if (!n)
+        throw Exception(__FILE__, __LINE__,
+                        "there is no trace at given inline and crossline");
+    seek_trace(n - 1);
+    return ISEGY::read_trace();
+}
+
+vector<double> ISEGY3D::inline_section(int64_t il) {
+    uint64_t from = pimpl->node(il, pimpl->grid.xl_first);
+    vector<uint64_t> trcs(pimpl->nodes.begin() + from,
+                          pimpl->nodes.begin() + from + pimpl->grid.xl_num);
+    return pimpl->read_samples(trcs, 0, pimpl->samp_num);
+}
+
+vector<double> ISEGY3D::crossline_section(int64_t xl) {
+    uint64_t from = pimpl->node(pimpl->grid.il_first, xl);
+    vector<uint64_t> trcs(pimpl->grid.il_num);
+    for (uint64_t i = 0; i < trcs.size(); ++i)
+        trcs[i] = pimpl->nodes[from + i * pimpl->grid.xl_num];
+    return pimpl->read_samples(trcs, 0, pimpl->samp_num);
+}
+
+vector<double> ISEGY3D::time_slice(uint32_t sample) {
+    if (sample >= pimpl->samp_num)
+        throw Exception(__FILE__, __LINE__, "sample is out of trace");
+    return pimpl->read_samples(pimpl->nodes, sample, 1);
+}
+
+ISEGY3D::Cube ISEGY3D::read_cube(unsigned threads) {
+    return pimpl->read_cube(threads);
+}
+
+ISEGY3D::ISEGY3D(
+    string file_name, string il_name, string xl_name,
+    vector<pair<string, map<uint32_t, pair<string, Trace::Header::ValueType>>>>
+        hdr_map)
+    : ISEGY(move(file_name), move(hdr_map)),
+      pimpl(make_unique<Impl>(*this, move(il_name), move(xl_name))) {}
+
+ISEGY3D::ISEGY3D(
+    string file_name, CommonSEGY::BinaryHeader bin_hdr, string il_name,
+    string xl_name,
+    vector<pair<string, map<uint32_t, pair<string, Trace::Header::ValueType>>>>
+        hdr_map)
+    : ISEGY(move(file_name), move(bin_hdr), move(hdr_map)),
+      pimpl(make_unique<Impl>(*this, move(il_name), move(xl_name))) {}
+
+ISEGY3D::~ISEGY3D() = default;
+} // namespace sedaman
@@ -0,0 +1,182 @@
+#include "ISEGYDataset.hpp"
+#include "Exception.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <limits>
+#include <list>
+#include <unordered_map>
+
+using std::list;
+using std::make_unique;
+using std::map;
+using std::move;
+using std::pair;
+using std::string;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+namespace sedaman {
+class ISEGYDataset::Impl {
+public:
+    Impl(vector<string> names, vector<pair<string, map<uint32_t,
+         pair<string, Trace::Header::ValueType>>>> hdr_map,
+         unsigned threads);
+    vector<string> names;
+    vector<pair<string, map<uint32_t,
+        pair<string, Trace::Header::ValueType>>>> hdr_map;
+    // found on construction, files are opened again without reading
+    // headers or walking through variable length traces
+    vector<ISEGY::Layout> layouts;
+    // global number of first trace of every file, last one is total number
+    vector<uint64_t> first;
+    // recently used readers, most recent first, so going back and forth
+    // between a few files does not open them again
+    static constexpr size_t max_open = 8;
+    struct Reader {
+        uint64_t file;
+        unique_ptr<ISEGY> sgy;
+        // global number of trace at current position, seek is skipped for
+        // traces read in order
+        uint64_t positioned;
+    };
+    list<Reader> readers;
+    // header values of all traces already collected by header_values
+    unordered_map<string, vector<Trace::Header::Value>> columns;
+    // global number of next trace to read
+    uint64_t next = 0;
+    pair<uint64_t, uint64_t> locate(uint64_t num);
+    Reader& open(uint64_t file);
+    ISEGY& prepare();
+};
+
+ISEGYDataset::Impl::Impl(vector<string> n, vector<pair<string,
+                         map<uint32_t, pair<string,
+                         Trace::Header::ValueType>>>> m, unsigned threads)
+    : names { move(n) }
+    , hdr_map { move(m) }
+    , layouts(names.size())
+    , first(names.size() + 1)
+{
+    parallel_for(names.size(), threads,
+                 [this](unsigned, uint64_t from, uint64_t to) {
+        for (uint64_t i = from; i < to; ++i) {
+            ISEGY s(names[i], hdr_map);
+            first[i + 1] = s.traces_count();
+            layouts[i] = s.layout();
+        }
+    });
+    for (uint64_t i = 0; i < names.size(); ++i)
+        first[i + 1] += first[i];
+}
+
+pair<uint64_t, uint64_t> ISEGYDataset::Impl::locate(uint64_t num)
+{
+    if (num >= first.back())
+        throw Exception(__FILE__, __LINE__, "no such trace in dataset");
+    uint64_t file = std::upper_bound(first.begin(), first.end(), num) -
+        first.begin() - 1;
+    return { file, num - first[file] };
+}
+
+ISEGYDataset::Impl::Reader& ISEGYDataset::Impl::open(uint64_t file)
+{
+    auto it = std::find_if(readers.begin(), readers.end(),
+                           [file](Reader const& r) { return r.file == file; });
+    if (it != readers.end()) {
+        readers.splice(readers.begin(), readers, it);
+        return readers.front();
+    }
+    if (readers.size() >= max_open)
+        readers.pop_back();
+    readers.push_front({ file, make_unique<ISEGY>(names[file], layouts[file],
+                                                  hdr_map),
+                         std::numeric_limits<uint64_t>::max() });
+    return readers.front();
+}
+
+ISEGY& ISEGYDataset::Impl::prepare()
+{
+    auto [file, trc] = locate(next);
+    Reader& r = open(file);
+    if (r.positioned != next)
+        r.sgy->seek_trace(trc);
+    r.positioned = ++next;
+    return *r.sgy;
+}
+
+ISEGYDataset::ISEGYDataset(vector<string> file_names,
+                           vector<pair<string, map<uint32_t,
+                           pair<string, Trace::Header::ValueType>>>> hdr_map,
+                           unsigned threads)
+    : pimpl { make_unique<Impl>(move(file_names), move(hdr_map), threads) }
+{
+}
+
+uint64_t ISEGYDataset::files_count() { return pimpl->names.size(); }
+
+string const& ISEGYDataset::file_name(uint64_t file)
+{
+    if (file >= pimpl->names.size())
+        throw Exception(__FILE__, __LINE__, "no such file in dataset");
+    return pimpl->names[file];
+}
+
+CommonSEGY::BinaryHeader const& ISEGYDataset::binary_header(uint64_t file)
+{
+    if (file >= pimpl->names.size())
+        throw Exception(__FILE__, __LINE__, "no such file in dataset");
+    return pimpl->layouts[file].binary_header;
+}
+
+uint64_t ISEGYDataset::traces_count() { return pimpl->first.back(); }
+
+pair<uint64_t, uint64_t> ISEGYDataset::locate(uint64_t num)
+{
+    return pimpl->locate(num);
+}
+
+void ISEGYDataset::seek_trace(uint64_t num)
+{
+    pimpl->locate(num);
+    pimpl->next = num;
+}
+
+bool ISEGYDataset::has_trace() { return pimpl->next < pimpl->first.back(); }
+
+Trace::Header ISEGYDataset::read_header()
+{
+    return pimpl->prepare().read_header();
+}
+
+Trace ISEGYDataset::read_trace() { return pimpl->prepare().read_trace(); }
+
+vector<Trace::Header::Value>
+ISEGYDataset::header_values(string const& name, unsigned threads)
+{
+    Impl& d = *pimpl;
+    auto it = d.columns.find(name);
+    if (it != d.columns.end())
+        return it->second;
+    vector<Trace::Header::Value> result(d.first.back());
+    parallel_for(d.names.size(), threads,
+                 [&](unsigned, uint64_t from, uint64_t to) {
+        for (uint64_t f = from; f < to; ++f) {
+            ISEGY s(d.names[f], d.layouts[f], d.hdr_map);
+            auto off = s.raw_header_offset(name);
+            if (!off)
+                throw Exception(__FILE__, __LINE__,
+                                "no such header in trace");
+            int32_t endianness = s.binary_header().endianness;
+            s.read_raw_headers([&](unsigned, uint64_t i, char const* hdrs) {
+                result[d.first[f] + i] = CommonSEGY::read_header_value(
+                    hdrs + off->first, off->second, endianness);
+            }, 1);
+        }
+    });
+    d.columns.emplace(name, result);
+    return result;
+}
+
+ISEGYDataset::~ISEGYDataset() = default;
+} // namespace sedaman
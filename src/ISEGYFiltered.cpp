@@ -0,0 +1,106 @@
+#include "ISEGYFiltered.hpp"
+#include "Exception.hpp"
+#include <algorithm>
+#include <thread>
+
+using std::make_unique;
+using std::map;
+using std::move;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace sedaman {
+class ISEGYFiltered::Impl {
+public:
+    Impl(ISEGYFiltered& s, string const& expression);
+    HeaderFilter filter;
+    bool scanned = false;
+    vector<uint64_t> selected;
+    vector<uint64_t>::size_type next = 0;
+    void scan(unsigned threads);
+    void seek_next();
+
+private:
+    ISEGYFiltered& sgy;
+};
+
+ISEGYFiltered::Impl::Impl(ISEGYFiltered& s, string const& expression)
+    : filter { expression, s }
+    , sgy { s }
+{
+}
+
+void ISEGYFiltered::Impl::scan(unsigned threads)
+{
+    if (scanned)
+        return;
+    // every thread gets contiguous range of traces, so merging per thread
+    // results in thread order keeps file order
+    vector<vector<uint64_t>> found(threads ? threads
+                                   : std::max(1u,
+                                         std::thread::hardware_concurrency()));
+    sgy.read_raw_headers([this, &found](unsigned thr, uint64_t i,
+                                        char const* hdrs) {
+        if (filter.matches(hdrs))
+            found[thr].push_back(i);
+    }, found.size());
+    for (auto& v : found)
+        selected.insert(selected.end(), v.begin(), v.end());
+    scanned = true;
+}
+
+void ISEGYFiltered::Impl::seek_next()
+{
+    if (!sgy.has_trace())
+        throw Exception(__FILE__, __LINE__, "there are no more traces");
+    sgy.seek_trace(selected[next++]);
+}
+
+ISEGYFiltered::ISEGYFiltered(string file_name, string const& expression,
+                             vector<pair<string, map<uint32_t,
+                             pair<string, Trace::Header::ValueType>>>>
+                                 hdr_map)
+    : ISEGY(move(file_name), move(hdr_map))
+    , pimpl { make_unique<Impl>(*this, expression) }
+{
+}
+
+ISEGYFiltered::ISEGYFiltered(string file_name, string const& expression,
+                             CommonSEGY::BinaryHeader binary_header,
+                             vector<pair<string, map<uint32_t,
+                             pair<string, Trace::Header::ValueType>>>>
+                                 hdr_map)
+    : ISEGY(move(file_name), move(binary_header), move(hdr_map))
+    , pimpl { make_unique<Impl>(*this, expression) }
+{
+}
+
+bool ISEGYFiltered::has_trace()
+{
+    pimpl->scan(0);
+    return pimpl->next < pimpl->selected.size();
+}
+
+Trace::Header ISEGYFiltered::read_header()
+{
+    pimpl->seek_next();
+    return ISEGY::read_header();
+}
+
+Trace ISEGYFiltered::read_trace()
+{
+    pimpl->seek_next();
+    return ISEGY::read_trace();
+}
+
+vector<uint64_t> const& ISEGYFiltered::selected(unsigned threads)
+{
+    pimpl->scan(threads);
+    return pimpl->selected;
+}
+
+HeaderFilter const& ISEGYFiltered::filter() { return pimpl->filter; }
+
+ISEGYFiltered::~ISEGYFiltered() = default;
+} // namespace sedaman
@@ -1295,5 +1295,6 @@ OSEGD::OSEGD(string file_name, CommonSEGD::GeneralHeader gh,
 			pimpl->chans_in_record += hdr.number_of_channels;
 }
 CommonSEGD& OSEGD::common() { return pimpl->common; }
+void OSEGD::flush() { pimpl->common.file.flush(); }
 OSEGD::~OSEGD() = default;
 } // namespace sedaman
@@ -1,25 +1,42 @@
 #include "OSEGY.hpp"
 #include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "ZStreambuf.hpp"
 #include "util.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cfloat>
 #include <climits>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <functional>
 #include <ios>
+#include <mutex>
 #include <variant>
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 using std::abs;
 using std::fstream;
 using std::function;
 using std::get;
+using std::holds_alternative;
 using std::ios_base;
 using std::make_unique;
 using std::map;
 using std::move;
+using std::mutex;
 using std::optional;
 using std::pair;
 using std::streampos;
 using std::string;
+using std::unordered_map;
 using std::vector;
 
 namespace sedaman {
@@ -28,6 +45,7 @@ public:
     Impl(CommonSEGY com)
         : common { move(com) }
     {
+        compile_plan();
     }
     CommonSEGY common;
     void assign_raw_writers();
@@ -40,6 +58,83 @@ public:
     void write_additional_trace_headers(Trace::Header const& hdr);
     void write_trace_samples_fix(Trace const& t);
     void write_trace_samples_var(Trace const& t);
+    // IEEE samples in host byte order are stored without per sample calls
+    bool native_ieee = false;
+    void encode_samples(vector<double> const& samples, char* out,
+                        optional<int> weight);
+    // samples scaled by 2^weight are rounded to integer format, weight is
+    // written to trace header
+    Quantization quantization = Quantization::none;
+    uint32_t weight_slot = 0;
+    optional<int> file_weight;
+    // weight of current trace written by write_trace
+    optional<int> weight;
+    double quant_range() const;
+    int compute_weight(vector<double> const& samples) const;
+    optional<int> weight_for(vector<double> const& samples);
+    // traces of batch are collected here and written at once
+    vector<char> stage;
+    bool staging = false;
+    // samples of current trace already encoded in output format
+    vector<char> const* raw = nullptr;
+    void put(char const* buf, size_t n);
+    void emit(char const* buf, size_t n);
+    // copy of everything written to file goes here when set, with
+    // offsets of trace headers in it
+    vector<char>* capture = nullptr;
+    vector<size_t>* capture_hdrs = nullptr;
+    void keep(char const* buf, size_t n);
+    // trace headers encoded by other writer are copied instead of encoding
+    vector<char> const* shared_buf = nullptr;
+    vector<size_t> const* shared_offs = nullptr;
+    size_t shared_next = 0;
+    char const* shared_cur = nullptr;
+    void put_shared_header(size_t i);
+    void flush_stage();
+    // header map compiled once: for every trace header list of fields with
+    // offset, type and slot in flat array of values of current trace
+    struct Field {
+        uint32_t offset;
+        Trace::Header::ValueType type;
+        uint32_t slot;
+    };
+    vector<vector<Field>> plan;
+    unordered_map<string, uint32_t> slots;
+    vector<Trace::Header::Value> values;
+    vector<char> present;
+    Trace::Header const* loaded = nullptr;
+    void compile_plan();
+    void load_values(Trace::Header const& hdr,
+                     vector<Trace::Header::Value>& vals,
+                     vector<char>& pres) const;
+    void encode_header(vector<Field> const& fields,
+                       vector<Trace::Header::Value> const& vals,
+                       vector<char> const& pres, char* out) const;
+    // positional writing of fixed length traces from several threads
+    // appending to existing file, traces written by write_trace are counted
+    bool appending = false;
+    uint64_t written = 0;
+    std::once_flag positional_init;
+    streampos data_start;
+    uint64_t hdrs_num = 0;
+    uint64_t trc_size = 0;
+    // max ordinal number written plus one
+    std::atomic<uint64_t> positional_num { 0 };
+    int fd = -1;
+    mutex file_mutex;
+    uint64_t fixed_trace_size();
+    void open_fd();
+    void init_positional();
+    void write_trace_at(uint64_t num, Trace const& tr);
+    // traces go to shared mapping of preallocated file, file is cut to
+    // written size when mapping is closed
+    char* map = nullptr;
+    uint64_t map_size = 0;
+    uint64_t map_pos = 0;
+    void reserve_traces(uint64_t num);
+    void grow_mapping(uint64_t size);
+    char* direct(size_t n);
+    void close_mapping();
 
 private:
     function<void(char**, uint8_t)> write_u8;
@@ -63,7 +158,7 @@ void OSEGY::Impl::assign_raw_writers()
     write_u8 = [](char** buf, uint8_t val) { write<uint8_t>(buf, val); };
     write_i8 = [](char** buf, int8_t val) { write<int8_t>(buf, val); };
     switch (common.binary_header.endianness) {
-    case 0x01020304:
+    case CommonSEGY::NATIVE_ENDIANNESS:
         write_u16 = [](char** buf, uint16_t val)
 	   	{ write<uint16_t>(buf, val); };
         write_i16 = [](char** buf, int16_t val) { write<int16_t>(buf, val); };
@@ -231,6 +326,10 @@ void OSEGY::Impl::assign_sample_writer()
     default:
         throw(Exception(__FILE__, __LINE__, "unsupported format"));
     }
+    native_ieee = FLT_RADIX == 2 && DBL_MANT_DIG == 53 &&
+        common.binary_header.endianness == CommonSEGY::NATIVE_ENDIANNESS &&
+        (common.binary_header.format_code == 5 ||
+         common.binary_header.format_code == 6);
 }
 
 void OSEGY::Impl::write_bin_header()
@@ -271,7 +370,8 @@ void OSEGY::Impl::write_bin_header()
     write_IEEE_double(&ptr, common.binary_header.ext_samp_int_orig);
     write_i32(&ptr, common.binary_header.ext_samp_per_tr_orig);
     write_i32(&ptr, common.binary_header.ext_ens_fold);
-    write_i32(&ptr, common.binary_header.endianness);
+    // endianness is written as is, it is the byte order itself
+    write<int32_t>(&ptr, common.binary_header.endianness);
     ptr += 200;
     write_u8(&ptr, common.binary_header.SEGY_rev_major_ver);
     write_u8(&ptr, common.binary_header.SEGY_rev_minor_ver);
@@ -282,143 +382,186 @@ void OSEGY::Impl::write_bin_header()
     write_u64(&ptr, common.binary_header.num_of_tr_in_file);
     write_u64(&ptr, common.binary_header.byte_off_of_first_tr);
     write_i32(&ptr, common.binary_header.num_of_trailer_stanza);
+    // it could be rewritten after traces, so position is restored
+    streampos pos = common.file.tellp();
 	common.file.seekg(CommonSEGY::TEXT_HEADER_SIZE, ios_base::beg);
     common.file.write(buf, CommonSEGY::BIN_HEADER_SIZE);
+    if (pos > common.file.tellp())
+        common.file.seekp(pos);
+}
+
+static int64_t as_int(Trace::Header::Value const& v)
+{
+    return holds_alternative<int64_t>(v) ? get<int64_t>(v)
+                                         : llround(get<double>(v));
+}
+
+static double as_double(Trace::Header::Value const& v)
+{
+    return holds_alternative<int64_t>(v) ? get<int64_t>(v) : get<double>(v);
+}
+
+void OSEGY::Impl::compile_plan()
+{
+    plan.clear();
+    slots.clear();
+    size_t hdrs_num = std::min<size_t>(
+        common.tr_hdr_map.size(),
+        static_cast<size_t>(
+            std::max(common.binary_header.max_num_add_tr_headers, 0)) + 1);
+    plan.resize(hdrs_num);
+    for (size_t i = 0; i < hdrs_num; ++i)
+        for (auto& p : common.tr_hdr_map[i].second) {
+            auto [it, added] = slots.emplace(p.second.first, slots.size());
+            plan[i].push_back({ p.first, p.second.second, it->second });
+        }
+}
+
+void OSEGY::Impl::load_values(Trace::Header const& hdr,
+                              vector<Trace::Header::Value>& vals,
+                              vector<char>& pres) const
+{
+    vals.resize(slots.size());
+    pres.assign(slots.size(), 0);
+    hdr.for_each([&](string const& key, Trace::Header::Value const& v) {
+        auto it = slots.find(key);
+        if (it != slots.end()) {
+            vals[it->second] = v;
+            pres[it->second] = 1;
+        }
+    });
+}
+
+void OSEGY::Impl::encode_header(vector<Field> const& fields,
+                                vector<Trace::Header::Value> const& vals,
+                                vector<char> const& pres, char* out) const
+{
+    std::memset(out, 0, CommonSEGY::TR_HEADER_SIZE);
+    for (Field const& f : fields) {
+        if (!pres[f.slot])
+            continue;
+        Trace::Header::Value const& v = vals[f.slot];
+        char* pos = out + f.offset;
+        switch (f.type) {
+        case Trace::Header::ValueType::int8_t:
+            write_i8(&pos, as_int(v));
+            break;
+        case Trace::Header::ValueType::uint8_t:
+            write_u8(&pos, as_int(v));
+            break;
+        case Trace::Header::ValueType::int16_t:
+            write_i16(&pos, as_int(v));
+            break;
+        case Trace::Header::ValueType::uint16_t:
+            write_u16(&pos, as_int(v));
+            break;
+        case Trace::Header::ValueType::int24_t:
+            write_i24(&pos, as_int(v));
+            break;
+        case Trace::Header::ValueType::uint24_t:
+            write_u24(&pos, as_int(v));
+            break;
+        case Trace::Header::ValueType::int32_t:
+            write_i32(&pos, as_int(v));
+            break;
+        case Trace::Header::ValueType::uint32_t:
+            write_u32(&pos, as_int(v));
+            break;
+        case Trace::Header::ValueType::int64_t:
+            write_i64(&pos, as_int(v));
+            break;
+        case Trace::Header::ValueType::uint64_t:
+            write_u64(&pos, as_int(v));
+            break;
+        case Trace::Header::ValueType::ibm:
+            write_ibm_float(&pos, as_double(v));
+            break;
+        case Trace::Header::ValueType::ieee_single:
+            write_IEEE_float(&pos, as_double(v));
+            break;
+        case Trace::Header::ValueType::ieee_double:
+            write_IEEE_double(&pos, as_double(v));
+            break;
+        }
+    }
 }
 
 void OSEGY::Impl::write_trace_header(Trace::Header const& hdr)
 {
-    std::memset(common.hdr_buf, 0, CommonSEGY::TR_HEADER_SIZE);
-    optional<Trace::Header::Value> tmp;
-	for (auto& p : common.tr_hdr_map[0].second) {
-		char* pos = common.hdr_buf + p.first;
-		switch (p.second.second) {
-			case Trace::Header::ValueType::int8_t:
-				tmp = hdr.get(p.second.first);
-				write_i8(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::uint8_t:
-				tmp = hdr.get(p.second.first);
-				write_u8(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::int16_t:
-				tmp = hdr.get(p.second.first);
-				write_i16(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::uint16_t:
-				tmp = hdr.get(p.second.first);
-				write_u16(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::int24_t:
-				tmp = hdr.get(p.second.first);
-				write_i24(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::uint24_t:
-				tmp = hdr.get(p.second.first);
-				write_u24(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::int32_t:
-				tmp = hdr.get(p.second.first);
-				write_i32(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::uint32_t:
-				tmp = hdr.get(p.second.first);
-				write_u32(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::int64_t:
-				tmp = hdr.get(p.second.first);
-				write_i64(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::uint64_t:
-				tmp = hdr.get(p.second.first);
-				write_u64(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::ibm:
-				tmp = hdr.get(p.second.first);
-				write_ibm_float(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::ieee_single:
-				tmp = hdr.get(p.second.first);
-				write_IEEE_float(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-			case Trace::Header::ValueType::ieee_double:
-				tmp = hdr.get(p.second.first);
-				write_IEEE_double(&pos, tmp ? get<int64_t>(*tmp) : 0);
-				break;
-		}
-	}
-    common.file.write(common.hdr_buf, CommonSEGY::TR_HEADER_SIZE);
+    if (capture_hdrs)
+        capture_hdrs->push_back(capture->size() +
+                                (staging ? stage.size() : 0));
+    if (shared_buf) {
+        ++written;
+        shared_cur = shared_buf->data() + (*shared_offs)[shared_next++];
+        put_shared_header(0);
+        return;
+    }
+    load_values(hdr, values, present);
+    if (weight) {
+        values[weight_slot] = static_cast<int64_t>(*weight);
+        present[weight_slot] = 1;
+    }
+    loaded = &hdr;
+    ++written;
+    if (char* out = direct(CommonSEGY::TR_HEADER_SIZE)) {
+        encode_header(plan[0], values, present, out);
+        keep(out, CommonSEGY::TR_HEADER_SIZE);
+        return;
+    }
+    encode_header(plan[0], values, present, common.hdr_buf);
+    put(common.hdr_buf, CommonSEGY::TR_HEADER_SIZE);
 }
 
 void OSEGY::Impl::write_additional_trace_headers(Trace::Header const& hdr)
 {
-    char* buf = common.hdr_buf;
-	for (decltype(common.binary_header.max_num_add_tr_headers) i = 1;
-		 i < common.binary_header.max_num_add_tr_headers; ++i) {
-		std::memset(buf, 0, CommonSEGY::TR_HEADER_SIZE);
-		if (static_cast<decltype(common.tr_hdr_map.size())>(i) <
-		   	common.tr_hdr_map.size()) {
-			for (auto& p : common.tr_hdr_map[i].second) {
-				optional<Trace::Header::Value> tmp;
-				char* pos = common.hdr_buf + p.first;
-				switch (p.second.second) {
-					case Trace::Header::ValueType::int8_t:
-						tmp = hdr.get(p.second.first);
-						write_i8(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::uint8_t:
-						tmp = hdr.get(p.second.first);
-						write_u8(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::int16_t:
-						tmp = hdr.get(p.second.first);
-						write_i16(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::uint16_t:
-						tmp = hdr.get(p.second.first);
-						write_u16(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::int24_t:
-						tmp = hdr.get(p.second.first);
-						write_i24(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::uint24_t:
-						tmp = hdr.get(p.second.first);
-						write_u24(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::int32_t:
-						tmp = hdr.get(p.second.first);
-						write_i32(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::uint32_t:
-						tmp = hdr.get(p.second.first);
-						write_u32(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::int64_t:
-						tmp = hdr.get(p.second.first);
-						write_i64(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::uint64_t:
-						tmp = hdr.get(p.second.first);
-						write_u64(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::ibm:
-						tmp = hdr.get(p.second.first);
-						write_ibm_float(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::ieee_single:
-						tmp = hdr.get(p.second.first);
-						write_IEEE_float(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-					case Trace::Header::ValueType::ieee_double:
-						tmp = hdr.get(p.second.first);
-						write_IEEE_double(&pos, tmp ? get<int64_t>(*tmp) : 0);
-						break;
-				}
-			}
-		}
-		common.file.write(common.hdr_buf, CommonSEGY::TR_HEADER_SIZE);
-	}
+    if (shared_buf) {
+        for (decltype(common.binary_header.max_num_add_tr_headers) i = 1;
+             i <= common.binary_header.max_num_add_tr_headers; ++i)
+            put_shared_header(i);
+        return;
+    }
+    // values are usually loaded by write_trace_header for the same trace
+    if (&hdr != loaded) {
+        load_values(hdr, values, present);
+        if (weight) {
+            values[weight_slot] = static_cast<int64_t>(*weight);
+            present[weight_slot] = 1;
+        }
+    }
+    loaded = nullptr;
+    static vector<Field> const empty;
+    for (decltype(common.binary_header.max_num_add_tr_headers) i = 1;
+         i <= common.binary_header.max_num_add_tr_headers; ++i) {
+        vector<Field> const& fields =
+            static_cast<size_t>(i) < plan.size() ? plan[i] : empty;
+        if (char* out = direct(CommonSEGY::TR_HEADER_SIZE)) {
+            encode_header(fields, values, present, out);
+            keep(out, CommonSEGY::TR_HEADER_SIZE);
+            continue;
+        }
+        encode_header(fields, values, present, common.hdr_buf);
+        put(common.hdr_buf, CommonSEGY::TR_HEADER_SIZE);
+    }
+}
+
+void OSEGY::Impl::put_shared_header(size_t i)
+{
+    char* out = direct(CommonSEGY::TR_HEADER_SIZE);
+    char* dst = out ? out : common.hdr_buf;
+    memcpy(dst, shared_cur + i * CommonSEGY::TR_HEADER_SIZE,
+           CommonSEGY::TR_HEADER_SIZE);
+    // only weight of quantized samples differs from other writer
+    if (weight && i < plan.size())
+        for (Field const& f : plan[i])
+            if (f.slot == weight_slot)
+                CommonSEGY::write_header_value(dst + f.offset, f.type,
+                    static_cast<int64_t>(*weight),
+                    common.binary_header.endianness);
+    if (out)
+        keep(out, CommonSEGY::TR_HEADER_SIZE);
+    else
+        put(common.hdr_buf, CommonSEGY::TR_HEADER_SIZE);
 }
 
 void OSEGY::Impl::write_ext_text_headers()
@@ -451,11 +594,295 @@ void OSEGY::Impl::write_trace_samples_var(Trace const& t)
 
 void OSEGY::Impl::write_trace_samples_fix(Trace const& t)
 {
-    char* buf = common.samp_buf.data();
-    vector<double> const& samples = t.samples();
-    for (auto samp : samples)
-        write_sample(&buf, samp);
-    common.file.write(common.samp_buf.data(), common.samp_buf.size());
+    if (raw) {
+        if (raw->size() != common.samp_buf.size())
+            throw Exception(__FILE__, __LINE__,
+                            "wrong number of samples in raw trace");
+        put(raw->data(), raw->size());
+        return;
+    }
+    if (t.samples().size() * common.bytes_per_sample !=
+        common.samp_buf.size())
+        throw Exception(__FILE__, __LINE__,
+                        "wrong number of samples in trace");
+    if (char* out = direct(common.samp_buf.size())) {
+        encode_samples(t.samples(), out, weight);
+        keep(out, common.samp_buf.size());
+        return;
+    }
+    encode_samples(t.samples(), common.samp_buf.data(), weight);
+    put(common.samp_buf.data(), common.samp_buf.size());
+}
+
+void OSEGY::Impl::encode_samples(vector<double> const& samples, char* out,
+                                 optional<int> weight)
+{
+    if (weight) {
+        double range = quant_range();
+        for (double samp : samples) {
+            double v = std::nearbyint(std::ldexp(samp, *weight));
+            write_sample(&out, std::clamp(v, -range - 1, range));
+        }
+    } else if (!native_ieee) {
+        for (double samp : samples)
+            write_sample(&out, samp);
+    } else if (common.binary_header.format_code == 6) {
+        memcpy(out, samples.data(), samples.size() * sizeof(double));
+    } else {
+        for (double samp : samples) {
+            float tmp = samp;
+            memcpy(out, &tmp, sizeof(tmp));
+            out += sizeof(tmp);
+        }
+    }
+}
+
+double OSEGY::Impl::quant_range() const
+{
+    return common.binary_header.format_code == 3 ? INT16_MAX : INT8_MAX;
+}
+
+int OSEGY::Impl::compute_weight(vector<double> const& samples) const
+{
+    double max = 0;
+    for (double samp : samples)
+        max = std::max(max, abs(samp));
+    if (!std::isfinite(max))
+        throw Exception(__FILE__, __LINE__,
+                        "infinite or NaN samples could not be quantized");
+    if (max == 0)
+        return 0;
+    // the biggest power of 2 keeping maximal sample in range
+    double range = quant_range();
+    int result = std::ilogb(range / max);
+    while (std::ldexp(max, result) > range)
+        --result;
+    while (std::ldexp(max, result + 1) <= range)
+        ++result;
+    return std::clamp<int>(result, INT16_MIN, INT16_MAX);
+}
+
+optional<int> OSEGY::Impl::weight_for(vector<double> const& samples)
+{
+    switch (quantization) {
+    case Quantization::none:
+        return {};
+    case Quantization::trace:
+        return compute_weight(samples);
+    case Quantization::file:
+        break;
+    }
+    std::lock_guard<mutex> lock(file_mutex);
+    // zero traces fit any weight, so it is taken from the first nonzero one
+    if (!file_weight) {
+        int w = compute_weight(samples);
+        if (w || std::any_of(samples.begin(), samples.end(),
+                             [](double s) { return s != 0; }))
+            file_weight = w;
+        return w;
+    }
+    return file_weight;
+}
+
+void OSEGY::Impl::put(char const* buf, size_t n)
+{
+    if (staging)
+        stage.insert(stage.end(), buf, buf + n);
+    else
+        emit(buf, n);
+}
+
+void OSEGY::Impl::keep(char const* buf, size_t n)
+{
+    if (capture)
+        capture->insert(capture->end(), buf, buf + n);
+}
+
+void OSEGY::Impl::emit(char const* buf, size_t n)
+{
+    keep(buf, n);
+    if (char* out = direct(n))
+        memcpy(out, buf, n);
+    else
+        common.file.write(buf, n);
+}
+
+uint64_t OSEGY::Impl::fixed_trace_size()
+{
+    CommonSEGY::BinaryHeader const& bh = common.binary_header;
+    if ((bh.SEGY_rev_major_ver > 1 && !bh.fixed_tr_length) ||
+        !static_cast<uint16_t>(bh.samp_per_tr))
+        throw Exception(__FILE__, __LINE__, "fixed trace length is needed");
+    hdrs_num = static_cast<uint64_t>(
+                   std::max(bh.max_num_add_tr_headers, 0)) + 1;
+    return CommonSEGY::TR_HEADER_SIZE * hdrs_num +
+        static_cast<uint64_t>(static_cast<uint16_t>(bh.samp_per_tr)) *
+            common.bytes_per_sample;
+}
+
+void OSEGY::Impl::open_fd()
+{
+#ifdef __unix__
+    if (fd != -1)
+        return;
+    fd = ::open(common.file_name.c_str(), O_RDWR);
+    if (fd < 0)
+        throw Exception(__FILE__, __LINE__,
+                        "unable to open " + common.file_name + ": " +
+                            std::strerror(errno));
+#endif
+}
+
+void OSEGY::Impl::init_positional()
+{
+    trc_size = fixed_trace_size();
+    // traces go after everything written so far
+    common.file.flush();
+    data_start = map ? static_cast<streampos>(map_pos) : common.file.tellp();
+    open_fd();
+}
+
+void OSEGY::Impl::reserve_traces(uint64_t num)
+{
+#ifdef __unix__
+    uint64_t size = fixed_trace_size();
+    if (!map) {
+        common.file.flush();
+        map_pos = common.file.tellp();
+        open_fd();
+    }
+    grow_mapping(std::max(map_size, map_pos + num * size));
+#else
+    (void)num;
+#endif
+}
+
+void OSEGY::Impl::grow_mapping(uint64_t size)
+{
+#ifdef __unix__
+    if (map && size == map_size)
+        return;
+    // allocated at once file is not fragmented
+    int err = ::posix_fallocate(fd, 0, size);
+    // not every file system supports allocation
+    if (err == EINVAL || err == EOPNOTSUPP)
+        err = ::ftruncate(fd, size) ? errno : 0;
+    if (err)
+        throw Exception(__FILE__, __LINE__,
+                        "unable to allocate " + common.file_name + ": " +
+                            std::strerror(err));
+    if (map)
+        ::munmap(map, map_size);
+    map = nullptr;
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+        throw Exception(__FILE__, __LINE__,
+                        "unable to map " + common.file_name + ": " +
+                            std::strerror(errno));
+    map = static_cast<char*>(p);
+    map_size = size;
+#else
+    (void)size;
+#endif
+}
+
+char* OSEGY::Impl::direct(size_t n)
+{
+    if (!map || staging)
+        return nullptr;
+    // writing more traces than reserved doubles the mapping
+    if (map_pos + n > map_size)
+        grow_mapping(std::max(map_pos + n, map_size * 2));
+    char* out = map + map_pos;
+    map_pos += n;
+    return out;
+}
+
+void OSEGY::Impl::close_mapping()
+{
+#ifdef __unix__
+    if (!map)
+        return;
+    uint64_t end = map_pos;
+    if (positional_num)
+        end = std::max<uint64_t>(end, static_cast<uint64_t>(data_start) +
+                                          positional_num * trc_size);
+    ::munmap(map, map_size);
+    map = nullptr;
+    if (::ftruncate(fd, end))
+        throw Exception(__FILE__, __LINE__,
+                        "unable to truncate " + common.file_name + ": " +
+                            std::strerror(errno));
+    common.file.seekp(end);
+#endif
+}
+
+void OSEGY::Impl::write_trace_at(uint64_t num, Trace const& tr)
+{
+    std::call_once(positional_init, [this] { init_positional(); });
+    uint32_t samp_num =
+        static_cast<uint16_t>(common.binary_header.samp_per_tr);
+    if (tr.samples().size() != samp_num)
+        throw Exception(__FILE__, __LINE__,
+                        "number of samples differs from binary header");
+    // encoding buffers of calling thread
+    thread_local vector<Trace::Header::Value> vals;
+    thread_local vector<char> pres;
+    thread_local vector<char> buf;
+    buf.resize(trc_size);
+    load_values(tr.header_const(), vals, pres);
+    optional<int> w = weight_for(tr.samples());
+    if (w) {
+        vals[weight_slot] = static_cast<int64_t>(*w);
+        pres[weight_slot] = 1;
+    }
+    uint64_t off = static_cast<uint64_t>(data_start) + num * trc_size;
+    // reserved traces are encoded right into mapping, it is never
+    // remapped while traces are written by number
+    bool mapped = map && off + trc_size <= map_size;
+    static vector<Field> const empty;
+    char* out = mapped ? map + off : buf.data();
+    for (size_t i = 0; i < hdrs_num; ++i) {
+        encode_header(i < plan.size() ? plan[i] : empty, vals, pres, out);
+        out += CommonSEGY::TR_HEADER_SIZE;
+    }
+    encode_samples(tr.samples(), out, w);
+    if (mapped) {
+        uint64_t prev = positional_num.load();
+        while (prev < num + 1 &&
+               !positional_num.compare_exchange_weak(prev, num + 1))
+            ;
+        return;
+    }
+#ifdef __unix__
+    for (size_t done = 0; done < buf.size();) {
+        ssize_t n = ::pwrite(fd, buf.data() + done, buf.size() - done,
+                             off + done);
+        if (n < 0 && errno != EINTR)
+            throw Exception(__FILE__, __LINE__,
+                            string("positional write failed: ") +
+                                std::strerror(errno));
+        if (n > 0)
+            done += n;
+    }
+#else
+    {
+        std::lock_guard<mutex> lock(file_mutex);
+        common.file.seekp(off);
+        common.file.write(buf.data(), buf.size());
+    }
+#endif
+    uint64_t prev = positional_num.load();
+    while (prev < num + 1 &&
+           !positional_num.compare_exchange_weak(prev, num + 1))
+        ;
+}
+
+void OSEGY::Impl::flush_stage()
+{
+    staging = false;
+    emit(stage.data(), stage.size());
+    stage.clear();
 }
 
 OSEGY::OSEGY(string name, CommonSEGY::BinaryHeader bh,
@@ -466,7 +893,107 @@ OSEGY::OSEGY(string name, CommonSEGY::BinaryHeader bh,
 {
 }
 
+OSEGY::OSEGY(string name, Append, vector<pair<string, map<uint32_t,
+             pair<string, Trace::Header::ValueType>>>> hdr_map)
+    : pimpl { make_unique<Impl>(CommonSEGY { name,
+        fstream::in | fstream::out | fstream::binary, {}, hdr_map }) }
+{
+    if (ZStreambuf::is_compressed(name))
+        throw Exception(__FILE__, __LINE__,
+                        "traces could not be appended to compressed file");
+    ISEGY in(name, move(hdr_map));
+    CommonSEGY& com = pimpl->common;
+    com.binary_header = in.binary_header();
+    com.text_headers = in.text_headers();
+    com.trailer_stanzas = in.trailer_stanzas();
+    uint64_t end = std::filesystem::file_size(name) -
+        com.trailer_stanzas.size() * CommonSEGY::TEXT_HEADER_SIZE;
+    // trailer stanzas are written again after new traces
+    if (!com.trailer_stanzas.empty())
+        std::filesystem::resize_file(name, end);
+    com.file.seekp(end);
+    pimpl->appending = true;
+    pimpl->compile_plan();
+}
+
+void OSEGY::write_traces(vector<Trace>& traces) { write_batch(traces); }
+
+void OSEGY::write_batch(std::span<Trace> traces)
+{
+    pimpl->stage.clear();
+    pimpl->staging = true;
+    uint64_t written = pimpl->written;
+    try {
+        for (Trace& tr : traces)
+            write_trace(tr);
+    } catch (...) {
+        // nothing of failed batch is written
+        pimpl->staging = false;
+        pimpl->stage.clear();
+        pimpl->written = written;
+        throw;
+    }
+    pimpl->flush_stage();
+}
+
+void OSEGY::write_traces(vector<unordered_map<string, Trace::Header::Value>>
+                             headers,
+                         vector<double> const& samples)
+{
+    if (headers.empty())
+        return;
+    if (samples.size() % headers.size())
+        throw Exception(__FILE__, __LINE__,
+                        "number of samples is not multiple of number of "
+                        "headers");
+    size_t samp_num = samples.size() / headers.size();
+    vector<Trace> traces;
+    traces.reserve(headers.size());
+    for (size_t i = 0; i < headers.size(); ++i)
+        traces.emplace_back(move(headers[i]),
+                            vector<double>(samples.begin() + i * samp_num,
+                                           samples.begin() +
+                                               (i + 1) * samp_num));
+    write_traces(traces);
+}
+
+void OSEGY::write_raw_trace(Trace::Header hdr, vector<char> const& samples,
+                            int16_t format_code, int32_t endianness)
+{
+    int bytes = CommonSEGY::format_bytes(format_code);
+    if (samples.size() % bytes)
+        throw Exception(__FILE__, __LINE__,
+                        "size of raw samples is not multiple of sample size");
+    CommonSEGY::BinaryHeader const& bh = pimpl->common.binary_header;
+    bool same_order = bytes == 1 ||
+        (endianness == CommonSEGY::NATIVE_ENDIANNESS) ==
+            (bh.endianness == CommonSEGY::NATIVE_ENDIANNESS);
+    if (format_code == bh.format_code && same_order) {
+        Trace tr(move(hdr), {});
+        pimpl->raw = &samples;
+        try {
+            write_trace(tr);
+        } catch (...) {
+            pimpl->raw = nullptr;
+            throw;
+        }
+        pimpl->raw = nullptr;
+    } else {
+        vector<double> smpls(samples.size() / bytes);
+        CommonSEGY::read_samples(samples.data(), smpls.data(), smpls.size(),
+                                 format_code, endianness);
+        Trace tr(move(hdr), move(smpls));
+        write_trace(tr);
+    }
+}
+
 CommonSEGY& OSEGY::common() { return pimpl->common; }
+streampos OSEGY::position()
+{
+    streampos pos = pimpl->map ? static_cast<streampos>(pimpl->map_pos)
+                               : pimpl->common.file.tellp();
+    return pos + static_cast<std::streamoff>(pimpl->stage.size());
+}
 void OSEGY::assign_raw_writers() { pimpl->assign_raw_writers(); }
 void OSEGY::assign_sample_writer() { pimpl->assign_sample_writer(); }
 void OSEGY::assign_bytes_per_sample() { pimpl->assign_bytes_per_sample(); }
@@ -490,5 +1017,111 @@ void OSEGY::write_trace_samples_var(Trace const& t)
     pimpl->write_trace_samples_var(t);
 }
 
-OSEGY::~OSEGY() = default;
+void OSEGY::write_trace_at(uint64_t num, Trace const& tr)
+{
+    pimpl->write_trace_at(num, tr);
+}
+
+void OSEGY::reserve_traces(uint64_t num) { pimpl->reserve_traces(num); }
+
+void OSEGY::flush() { pimpl->common.file.flush(); }
+
+void OSEGY::set_quantization(Quantization mode, string const& weight_key)
+{
+    if (mode != Quantization::none) {
+        int16_t format = pimpl->common.binary_header.format_code;
+        if (format != 3 && format != 8)
+            throw Exception(__FILE__, __LINE__,
+                            "quantization needs format 3 or 8");
+        auto it = pimpl->slots.find(weight_key);
+        if (it == pimpl->slots.end())
+            throw Exception(__FILE__, __LINE__,
+                            "trace header map has no " + weight_key);
+        pimpl->weight_slot = it->second;
+    }
+    pimpl->quantization = mode;
+    pimpl->file_weight.reset();
+}
+
+void OSEGY::capture_to(vector<char>* buf, vector<size_t>* hdrs)
+{
+    pimpl->capture = buf;
+    pimpl->capture_hdrs = buf ? hdrs : nullptr;
+}
+
+void OSEGY::share_headers(vector<char> const* buf, vector<size_t> const* offs)
+{
+    pimpl->shared_buf = buf;
+    pimpl->shared_offs = offs;
+    pimpl->shared_next = 0;
+}
+
+void OSEGY::write_encoded(vector<char> const& buf, uint64_t traces)
+{
+    pimpl->emit(buf.data(), buf.size());
+    pimpl->written += traces;
+}
+
+bool OSEGY::same_encoding(OSEGY const& other) const
+{
+    CommonSEGY::BinaryHeader const& x = pimpl->common.binary_header;
+    CommonSEGY::BinaryHeader const& y = other.pimpl->common.binary_header;
+    bool fixed = x.fixed_tr_length || x.SEGY_rev_major_ver < 2;
+    return same_headers(other) &&
+        pimpl->quantization == Quantization::none &&
+        x.format_code == y.format_code &&
+        x.fixed_tr_length == y.fixed_tr_length &&
+        (!fixed || x.samp_per_tr == y.samp_per_tr);
+}
+
+bool OSEGY::same_headers(OSEGY const& other) const
+{
+    Impl const& a = *pimpl;
+    Impl const& b = *other.pimpl;
+    CommonSEGY::BinaryHeader const& x = a.common.binary_header;
+    CommonSEGY::BinaryHeader const& y = b.common.binary_header;
+    // headers of other writer must keep original weight values
+    return b.quantization == Quantization::none &&
+        (x.endianness == CommonSEGY::NATIVE_ENDIANNESS) ==
+            (y.endianness == CommonSEGY::NATIVE_ENDIANNESS) &&
+        x.SEGY_rev_major_ver == y.SEGY_rev_major_ver &&
+        x.max_num_add_tr_headers == y.max_num_add_tr_headers &&
+        a.common.tr_hdr_map == b.common.tr_hdr_map;
+}
+
+void OSEGY::choose_weight(Trace const& tr)
+{
+    // raw samples are written as they are with their own weight
+    pimpl->weight = pimpl->raw ? optional<int>()
+                               : pimpl->weight_for(tr.samples());
+}
+void OSEGY::close_mapping() { pimpl->close_mapping(); }
+
+OSEGY::~OSEGY()
+{
+    try {
+        pimpl->close_mapping();
+    } catch (...) {
+    }
+    CommonSEGY::BinaryHeader& bh = pimpl->common.binary_header;
+    uint64_t num = bh.num_of_tr_in_file;
+    if (pimpl->appending && num)
+        num += pimpl->written + pimpl->positional_num;
+    else if (pimpl->positional_num)
+        num = std::max<uint64_t>(num,
+                                 pimpl->written + pimpl->positional_num);
+#ifdef __unix__
+    if (pimpl->fd != -1)
+        ::close(pimpl->fd);
+#endif
+    // position of the end is used by revisions with trailer stanzas
+    if (bh.SEGY_rev_major_ver > 1 &&
+        num != bh.num_of_tr_in_file) {
+        bh.num_of_tr_in_file = num;
+        try {
+            pimpl->write_bin_header();
+        } catch (...) {
+        }
+    }
+}
 } // namespace sedaman
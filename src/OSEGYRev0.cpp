@@ -66,7 +66,7 @@ OSEGYRev0::Impl::Impl(OSEGYRev0& s, string txt_hdr)
         };
     } else {
         write_trace = [this](Trace& tr) {
-            if (sgy.common().file.tellg() == first_trace_pos) {
+            if (sgy.position() == first_trace_pos) {
                 //throw exception if trace header does not has a samples number
                 Trace::Header::Value v = *tr.header().get("SAMP_NUM");
                 int64_t samp_num = get<int64_t>(v);
@@ -100,6 +100,7 @@ OSEGYRev0::Impl::Impl(OSEGYRev0& s, string txt_hdr)
 
 void OSEGYRev0::write_trace(Trace& tr)
 {
+    choose_weight(tr);
     pimpl->write_trace(tr);
 }
 
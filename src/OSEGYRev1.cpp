@@ -1,5 +1,6 @@
 #include "OSEGYRev1.hpp"
 #include "Exception.hpp"
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <functional>
@@ -21,9 +22,11 @@ namespace sedaman {
 class OSEGYRev1::Impl {
 public:
     Impl(OSEGYRev1& s, vector<string> txt_hdrs);
+    Impl(OSEGYRev1& s);
     function<void(Trace& tr)> write_trace;
 
 private:
+    void assign_write_trace();
     OSEGYRev1& sgy;
     streampos first_trace_pos;
 };
@@ -55,6 +58,29 @@ OSEGYRev1::Impl::Impl(OSEGYRev1& s, vector<string> txt_hdrs)
 	first_trace_pos = sgy.common().file.tellg();
     sgy.assign_sample_writer();
     sgy.assign_bytes_per_sample();
+    assign_write_trace();
+}
+
+OSEGYRev1::Impl::Impl(OSEGYRev1& s)
+    : sgy { s }
+{
+    if (sgy.common().binary_header.SEGY_rev_major_ver > 1)
+        throw Exception(__FILE__, __LINE__,
+                        "traces of revision 2 file should be appended by "
+                        "OSEGYRev2");
+    CommonSEGY::BinaryHeader const& bh = sgy.common().binary_header;
+    first_trace_pos = CommonSEGY::TEXT_HEADER_SIZE +
+        CommonSEGY::BIN_HEADER_SIZE + static_cast<std::streamoff>(
+            std::max<int16_t>(bh.ext_text_headers_num, 0)) *
+        CommonSEGY::TEXT_HEADER_SIZE;
+    sgy.assign_raw_writers();
+    sgy.assign_sample_writer();
+    sgy.assign_bytes_per_sample();
+    assign_write_trace();
+}
+
+void OSEGYRev1::Impl::assign_write_trace()
+{
     CommonSEGY::BinaryHeader zero = {};
 	zero.format_code = 5;
     if (memcmp(&sgy.common().binary_header, &zero,
@@ -77,7 +103,7 @@ OSEGYRev1::Impl::Impl(OSEGYRev1& s, vector<string> txt_hdrs)
 		//if we have empty bin header we can not assume that traces has
 		//fixed length
 		write_trace = [this](Trace& tr) {
-			if (sgy.common().file.tellg() == first_trace_pos) {
+			if (sgy.position() == first_trace_pos) {
 				// throw exception if trace header does not has
 				// a samples number
 				Trace::Header::Value v = *tr.header().get("SAMP_NUM");
@@ -113,6 +139,7 @@ OSEGYRev1::Impl::Impl(OSEGYRev1& s, vector<string> txt_hdrs)
 
 void OSEGYRev1::write_trace(Trace& tr)
 {
+    choose_weight(tr);
     pimpl->write_trace(tr);
 }
 
@@ -125,5 +152,13 @@ OSEGYRev1::OSEGYRev1(string name, vector<string> ths,
 {
 }
 
+OSEGYRev1::OSEGYRev1(string name, Append,
+					 vector<pair<string, map<uint32_t,
+	   				 pair<string, Trace::Header::ValueType>>>> tr_hdrs_map)
+    : OSEGY { move(name), Append(), move(tr_hdrs_map) }
+    , pimpl { make_unique<Impl>(*this) }
+{
+}
+
 OSEGYRev1::~OSEGYRev1() = default;
 } // namespace sedaman
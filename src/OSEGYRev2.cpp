@@ -1,5 +1,6 @@
 #include "OSEGYRev2.hpp"
 #include "Exception.hpp"
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <functional>
@@ -22,9 +23,11 @@ namespace sedaman {
 class OSEGYRev2::Impl {
 public:
     Impl(OSEGYRev2& s, vector<string> txt_hdrs, vector<string> trlr_stnzs);
+    Impl(OSEGYRev2& s);
     function<void(Trace& tr)> write_trace;
 
 private:
+    void assign_write_trace();
     void set_min_hdrs(Trace& tr);
     OSEGYRev2& sgy;
     streampos first_trace_pos;
@@ -62,6 +65,25 @@ OSEGYRev2::Impl::Impl(OSEGYRev2& s, vector<string> txt_hdrs,
 	first_trace_pos = sgy.common().file.tellg();
     sgy.assign_sample_writer();
     sgy.assign_bytes_per_sample();
+    assign_write_trace();
+}
+
+OSEGYRev2::Impl::Impl(OSEGYRev2& s)
+    : sgy { s }
+{
+    CommonSEGY::BinaryHeader const& bh = sgy.common().binary_header;
+    first_trace_pos = CommonSEGY::TEXT_HEADER_SIZE +
+        CommonSEGY::BIN_HEADER_SIZE + static_cast<std::streamoff>(
+            std::max<int16_t>(bh.ext_text_headers_num, 0)) *
+        CommonSEGY::TEXT_HEADER_SIZE;
+    sgy.assign_raw_writers();
+    sgy.assign_sample_writer();
+    sgy.assign_bytes_per_sample();
+    assign_write_trace();
+}
+
+void OSEGYRev2::Impl::assign_write_trace()
+{
     CommonSEGY::BinaryHeader zero = {};
 	zero.format_code = 5;
     if (memcmp(&sgy.common().binary_header, &zero,
@@ -129,7 +151,7 @@ OSEGYRev2::Impl::Impl(OSEGYRev2& s, vector<string> txt_hdrs,
 
 void OSEGYRev2::Impl::set_min_hdrs(Trace& tr)
 {
-    if (sgy.common().file.tellg() == first_trace_pos) {
+    if (sgy.position() == first_trace_pos) {
         // throw exception if trace header does not has a samples number
         Trace::Header::Value v = *tr.header().get("SAMP_NUM");
         int64_t samp_num = get<int64_t>(v);
@@ -153,6 +175,7 @@ void OSEGYRev2::Impl::set_min_hdrs(Trace& tr)
 
 void OSEGYRev2::write_trace(Trace& tr)
 {
+    choose_weight(tr);
     pimpl->write_trace(tr);
 }
 
@@ -166,8 +189,20 @@ OSEGYRev2::OSEGYRev2(string name, vector<string> ths,
 {
 }
 
+OSEGYRev2::OSEGYRev2(string name, Append,
+    vector<pair<string, map<uint32_t, pair<string,
+   	Trace::Header::ValueType>>>> add_hdr_map)
+    : OSEGY { move(name), Append(), move(add_hdr_map) }
+    , pimpl { make_unique<Impl>(*this) }
+{
+}
+
 OSEGYRev2::~OSEGYRev2()
 {
+    try {
+        close_mapping();
+    } catch (...) {
+    }
     common().file.seekg(0, ios_base::end);
     if (common().binary_header.num_of_trailer_stanza)
         write_trailer_stanzas();
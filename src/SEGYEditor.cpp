@@ -0,0 +1,184 @@
+#include "SEGYEditor.hpp"
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "ZStreambuf.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+using std::fstream;
+using std::make_unique;
+using std::map;
+using std::move;
+using std::pair;
+using std::streamoff;
+using std::streampos;
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+namespace sedaman {
+class SEGYEditor::Impl {
+public:
+    Impl(string name, vector<pair<string, map<uint32_t,
+         pair<string, Trace::Header::ValueType>>>> hdr_map);
+    ISEGY sgy;
+    CommonSEGY::BinaryHeader bh;
+    vector<pair<string, map<uint32_t,
+        pair<string, Trace::Header::ValueType>>>> tr_hdr_map;
+    // headers of trace taken into account, main and additional ones
+    size_t hdrs_num;
+    fstream file;
+    vector<char> raw;
+    vector<char> patched;
+    bool fixed_length() const;
+    Trace::Header decode(char const* buf) const;
+    void write_changed(uint64_t num, char const* orig, Trace::Header const& hdr);
+};
+
+static string check_plain(string name)
+{
+    if (ZStreambuf::is_compressed(name))
+        throw Exception(__FILE__, __LINE__,
+                        "compressed file could not be edited");
+    return name;
+}
+
+SEGYEditor::Impl::Impl(string name, vector<pair<string, map<uint32_t,
+                       pair<string, Trace::Header::ValueType>>>> hdr_map)
+    : sgy { check_plain(name), hdr_map }
+    , bh { sgy.binary_header() }
+    , tr_hdr_map { move(hdr_map) }
+{
+    hdrs_num = std::min<size_t>(tr_hdr_map.size(),
+        static_cast<size_t>(std::max(bh.max_num_add_tr_headers, 0)) + 1);
+    raw.resize(sgy.raw_headers_size());
+    patched.resize(raw.size());
+    file.exceptions(fstream::failbit | fstream::badbit);
+    file.open(name, fstream::in | fstream::out | fstream::binary);
+}
+
+bool SEGYEditor::Impl::fixed_length() const
+{
+    return bh.fixed_tr_length || bh.SEGY_rev_major_ver == 0;
+}
+
+Trace::Header SEGYEditor::Impl::decode(char const* buf) const
+{
+    unordered_map<string, Trace::Header::Value> hdr;
+    for (size_t i = 0; i < hdrs_num; ++i)
+        for (auto& p : tr_hdr_map[i].second)
+            hdr[p.second.first] = CommonSEGY::read_header_value(
+                buf + i * CommonSEGY::TR_HEADER_SIZE + p.first,
+                p.second.second, bh.endianness);
+    return Trace::Header(move(hdr));
+}
+
+void SEGYEditor::Impl::write_changed(uint64_t num, char const* orig,
+                                     Trace::Header const& hdr)
+{
+    std::memcpy(patched.data(), orig, patched.size());
+    for (size_t i = 0; i < hdrs_num; ++i)
+        for (auto& p : tr_hdr_map[i].second) {
+            auto v = hdr.get(p.second.first);
+            if (!v)
+                continue;
+            char* pos = patched.data() + i * CommonSEGY::TR_HEADER_SIZE +
+                p.first;
+            if (p.second.first == "SAMP_NUM" && !fixed_length() &&
+                CommonSEGY::read_header_value(pos, p.second.second,
+                    bh.endianness) != *v)
+                throw Exception(__FILE__, __LINE__,
+                    "number of samples of variable length trace could not "
+                    "be changed");
+            CommonSEGY::write_header_value(pos, p.second.second, *v,
+                                           bh.endianness);
+        }
+    // changed blocks are written by one call from first to last
+    size_t first = hdrs_num, last = 0;
+    for (size_t i = 0; i < hdrs_num; ++i)
+        if (std::memcmp(patched.data() + i * CommonSEGY::TR_HEADER_SIZE,
+                        orig + i * CommonSEGY::TR_HEADER_SIZE,
+                        CommonSEGY::TR_HEADER_SIZE)) {
+            first = std::min(first, i);
+            last = i;
+        }
+    if (first == hdrs_num)
+        return;
+    file.seekp(sgy.trace_position(num) +
+               static_cast<streamoff>(first * CommonSEGY::TR_HEADER_SIZE));
+    file.write(patched.data() + first * CommonSEGY::TR_HEADER_SIZE,
+               (last - first + 1) * CommonSEGY::TR_HEADER_SIZE);
+}
+
+SEGYEditor::SEGYEditor(string name, vector<pair<string, map<uint32_t,
+                       pair<string, Trace::Header::ValueType>>>> hdr_map)
+    : pimpl { make_unique<Impl>(move(name), move(hdr_map)) }
+{
+}
+
+CommonSEGY::BinaryHeader const& SEGYEditor::binary_header()
+{
+    return pimpl->bh;
+}
+
+void SEGYEditor::write_binary_header(CommonSEGY::BinaryHeader const& bh)
+{
+    CommonSEGY::BinaryHeader& old = pimpl->bh;
+    if (bh.format_code != old.format_code ||
+        bh.samp_per_tr != old.samp_per_tr ||
+        bh.ext_samp_per_tr != old.ext_samp_per_tr ||
+        bh.endianness != old.endianness ||
+        bh.SEGY_rev_major_ver != old.SEGY_rev_major_ver ||
+        bh.fixed_tr_length != old.fixed_tr_length ||
+        bh.ext_text_headers_num != old.ext_text_headers_num ||
+        bh.max_num_add_tr_headers != old.max_num_add_tr_headers ||
+        bh.byte_off_of_first_tr != old.byte_off_of_first_tr ||
+        bh.num_of_trailer_stanza != old.num_of_trailer_stanza ||
+        (old.SEGY_rev_major_ver > 1 &&
+         bh.num_of_tr_in_file != old.num_of_tr_in_file))
+        throw Exception(__FILE__, __LINE__,
+                        "binary header change alters file layout");
+    char buf[CommonSEGY::BIN_HEADER_SIZE];
+    pimpl->file.seekg(CommonSEGY::TEXT_HEADER_SIZE);
+    pimpl->file.read(buf, CommonSEGY::BIN_HEADER_SIZE);
+    CommonSEGY::format_binary_header(bh, buf);
+    pimpl->file.seekp(CommonSEGY::TEXT_HEADER_SIZE);
+    pimpl->file.write(buf, CommonSEGY::BIN_HEADER_SIZE);
+    old = bh;
+}
+
+uint64_t SEGYEditor::traces_count() { return pimpl->sgy.traces_count(); }
+
+Trace::Header SEGYEditor::read_header(uint64_t num)
+{
+    streampos pos = pimpl->sgy.trace_position(num);
+    pimpl->file.seekg(pos);
+    pimpl->file.read(pimpl->raw.data(), pimpl->raw.size());
+    return pimpl->decode(pimpl->raw.data());
+}
+
+void SEGYEditor::write_header(uint64_t num, Trace::Header const& hdr)
+{
+    streampos pos = pimpl->sgy.trace_position(num);
+    pimpl->file.seekg(pos);
+    pimpl->file.read(pimpl->raw.data(), pimpl->raw.size());
+    pimpl->write_changed(num, pimpl->raw.data(), hdr);
+}
+
+void SEGYEditor::edit_headers(std::function<void(uint64_t, Trace::Header&)>
+                              func)
+{
+    // headers are read by separate stream, only the trace just read is
+    // written, so read ahead data never become stale
+    pimpl->sgy.read_raw_headers([&](unsigned, uint64_t num, char const* buf) {
+        Trace::Header hdr = pimpl->decode(buf);
+        func(num, hdr);
+        pimpl->write_changed(num, buf, hdr);
+    }, 1);
+    pimpl->file.flush();
+}
+
+SEGYEditor::~SEGYEditor() = default;
+} // namespace sedaman
@@ -0,0 +1,191 @@
+#include "SEGYMerger.hpp"
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include <algorithm>
+#include <fstream>
+
+using std::make_unique;
+using std::map;
+using std::move;
+using std::ofstream;
+using std::pair;
+using std::streamoff;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace sedaman {
+class SEGYMerger::Impl {
+public:
+    Impl(string name, vector<string> renumber, vector<pair<string,
+         map<uint32_t, pair<string, Trace::Header::ValueType>>>> hdr_map);
+    string file_name;
+    vector<string> renumber_names;
+    vector<pair<string, map<uint32_t, pair<string, Trace::Header::ValueType>>>>
+        tr_hdr_map;
+    ofstream file;
+    bool started = false;
+    bool closed = false;
+    CommonSEGY::BinaryHeader bh;
+    char bin[CommonSEGY::BIN_HEADER_SIZE];
+    // offsets of renumbered values from start of raw trace headers
+    vector<pair<uint32_t, Trace::Header::ValueType>> offsets;
+    uint64_t written = 0;
+    vector<char> buf;
+    void start(ISEGY& in);
+    void check(CommonSEGY::BinaryHeader const& other);
+};
+
+static constexpr streamoff BLOCK_SIZE = 4 << 20;
+
+SEGYMerger::Impl::Impl(string name, vector<string> renumber, vector<pair<string,
+                       map<uint32_t, pair<string, Trace::Header::ValueType>>>>
+                           hdr_map)
+    : file_name { move(name) }
+    , renumber_names { move(renumber) }
+    , tr_hdr_map { move(hdr_map) }
+{
+    file.exceptions(ofstream::failbit | ofstream::badbit);
+    file.open(file_name, ofstream::binary);
+}
+
+void SEGYMerger::Impl::start(ISEGY& in)
+{
+    // text headers and binary header of the first file are copied as they are
+    unique_ptr<std::istream> fl = in.open_stream(false);
+    buf.resize(static_cast<streamoff>(in.trace_position(0)));
+    fl->read(buf.data(), buf.size());
+    file.write(buf.data(), buf.size());
+    std::copy_n(buf.data() + CommonSEGY::TEXT_HEADER_SIZE,
+                CommonSEGY::BIN_HEADER_SIZE, bin);
+    bh = in.binary_header();
+    size_t hdrs_num = std::min<size_t>(tr_hdr_map.size(),
+        static_cast<size_t>(std::max(bh.max_num_add_tr_headers, 0)) + 1);
+    for (size_t i = 0; i < hdrs_num; ++i)
+        for (auto& p : tr_hdr_map[i].second)
+            if (std::find(renumber_names.begin(), renumber_names.end(),
+                          p.second.first) != renumber_names.end())
+                offsets.emplace_back(i * CommonSEGY::TR_HEADER_SIZE + p.first,
+                                     p.second.second);
+    started = true;
+}
+
+static bool swapped(int32_t endianness)
+{
+    return endianness != CommonSEGY::NATIVE_ENDIANNESS;
+}
+
+void SEGYMerger::Impl::check(CommonSEGY::BinaryHeader const& other)
+{
+    bool fixed = bh.fixed_tr_length || bh.SEGY_rev_major_ver == 0;
+    bool other_fixed = other.fixed_tr_length || other.SEGY_rev_major_ver == 0;
+    if (other.format_code != bh.format_code ||
+        swapped(other.endianness) != swapped(bh.endianness) ||
+        other_fixed != fixed ||
+        (bh.SEGY_rev_major_ver > 1) != (other.SEGY_rev_major_ver > 1) ||
+        other.max_num_add_tr_headers != bh.max_num_add_tr_headers ||
+        (fixed && (other.samp_per_tr != bh.samp_per_tr ||
+                   other.ext_samp_per_tr != bh.ext_samp_per_tr)))
+        throw Exception(__FILE__, __LINE__,
+                        "file has different sample format or trace length");
+}
+
+SEGYMerger::SEGYMerger(string name, vector<string> renumber,
+                       vector<pair<string, map<uint32_t,
+                                pair<string, Trace::Header::ValueType>>>>
+                           hdr_map)
+    : pimpl { make_unique<Impl>(move(name), move(renumber), move(hdr_map)) }
+{
+}
+
+void SEGYMerger::add(string const& file_name)
+{
+    if (pimpl->closed)
+        throw Exception(__FILE__, __LINE__, "merger is closed");
+    ISEGY in(file_name, pimpl->tr_hdr_map);
+    uint64_t count = in.traces_count();
+    if (!count)
+        return;
+    if (pimpl->started)
+        pimpl->check(in.binary_header());
+    else
+        pimpl->start(in);
+    // end of the last trace is the end of traces data
+    vector<char> samples;
+    in.seek_trace(count - 1);
+    in.read_raw_trace(samples);
+    streamoff end = static_cast<streamoff>(in.trace_position(count - 1)) +
+        in.raw_headers_size() + samples.size();
+    unique_ptr<std::istream> fl = in.open_stream(false);
+    streamoff pos = in.trace_position(0);
+    fl->seekg(pos);
+    vector<char>& buf = pimpl->buf;
+    if (pimpl->offsets.empty()) {
+        while (pos < end) {
+            streamoff size = std::min(BLOCK_SIZE, end - pos);
+            buf.resize(size);
+            fl->read(buf.data(), size);
+            pimpl->file.write(buf.data(), size);
+            pos += size;
+        }
+        pimpl->written += count;
+        return;
+    }
+    // whole traces are gathered in blocks to patch headers in memory
+    uint64_t num = 0;
+    while (num < count) {
+        uint64_t last = num + 1;
+        streamoff to = last < count ? static_cast<streamoff>(
+            in.trace_position(last)) : end;
+        while (last < count) {
+            streamoff next = last + 1 < count ? static_cast<streamoff>(
+                in.trace_position(last + 1)) : end;
+            if (next - pos > BLOCK_SIZE)
+                break;
+            to = next;
+            ++last;
+        }
+        buf.resize(to - pos);
+        fl->read(buf.data(), buf.size());
+        for (uint64_t i = num; i < last; ++i) {
+            char* hdr = buf.data() +
+                (static_cast<streamoff>(in.trace_position(i)) - pos);
+            for (auto& p : pimpl->offsets)
+                CommonSEGY::write_header_value(hdr + p.first, p.second,
+                    static_cast<int64_t>(pimpl->written + 1),
+                    pimpl->bh.endianness);
+            ++pimpl->written;
+        }
+        pimpl->file.write(buf.data(), buf.size());
+        pos = to;
+        num = last;
+    }
+}
+
+uint64_t SEGYMerger::traces_count() { return pimpl->written; }
+
+void SEGYMerger::close()
+{
+    if (pimpl->closed)
+        return;
+    pimpl->closed = true;
+    if (pimpl->started && pimpl->bh.SEGY_rev_major_ver > 1) {
+        CommonSEGY::BinaryHeader bh = CommonSEGY::parse_binary_header(
+            pimpl->bin);
+        bh.num_of_tr_in_file = pimpl->written;
+        bh.num_of_trailer_stanza = 0;
+        CommonSEGY::format_binary_header(bh, pimpl->bin);
+        pimpl->file.seekp(CommonSEGY::TEXT_HEADER_SIZE);
+        pimpl->file.write(pimpl->bin, CommonSEGY::BIN_HEADER_SIZE);
+    }
+    pimpl->file.close();
+}
+
+SEGYMerger::~SEGYMerger()
+{
+    try {
+        close();
+    } catch (...) {
+    }
+}
+} // namespace sedaman
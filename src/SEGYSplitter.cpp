@@ -0,0 +1,223 @@
+#include "SEGYSplitter.hpp"
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+using std::fstream;
+using std::function;
+using std::list;
+using std::make_unique;
+using std::map;
+using std::move;
+using std::pair;
+using std::string;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+namespace sedaman {
+class SEGYSplitter::Impl {
+public:
+    Impl(string name, string k,
+         function<string(Trace::Header::Value const&)> out_name,
+         size_t max_o, size_t budget,
+         vector<pair<string, map<uint32_t,
+                                 pair<string, Trace::Header::ValueType>>>>
+             hdr_map);
+    ISEGY in;
+    string key;
+    function<string(Trace::Header::Value const&)> output_name;
+    size_t max_open;
+    size_t memory_budget;
+    vector<pair<string, map<uint32_t, pair<string, Trace::Header::ValueType>>>>
+        tr_hdr_map;
+    // headers taken into account, main and additional ones
+    size_t hdrs_num;
+    struct Output {
+        // trace headers encoded as in input and raw samples, so buffered
+        // size is what budget counts
+        vector<pair<vector<char>, vector<char>>> pending;
+        size_t pending_size = 0;
+        uint64_t traces = 0;
+        bool created = false;
+        unique_ptr<OSEGY> writer;
+        list<string>::iterator lru_pos;
+    };
+    unordered_map<string, Output> outputs;
+    // open outputs, the most recently used first
+    list<string> lru;
+    size_t buffered = 0;
+    void encode(Trace::Header const& hdr, char* buf);
+    Trace::Header decode(char const* buf);
+    void flush(string const& name, Output& out);
+    void open(string const& name, Output& out);
+    void set_traces_number(string const& name, uint64_t num);
+};
+
+SEGYSplitter::Impl::Impl(string name, string k,
+                         function<string(Trace::Header::Value const&)> out_name,
+                         size_t max_o, size_t budget,
+                         vector<pair<string, map<uint32_t,
+                                  pair<string, Trace::Header::ValueType>>>>
+                             hdr_map)
+    : in { move(name), hdr_map }
+    , key { move(k) }
+    , output_name { move(out_name) }
+    , max_open { std::max<size_t>(max_o, 1) }
+    , memory_budget { budget }
+    , tr_hdr_map { move(hdr_map) }
+{
+    hdrs_num = std::min<size_t>(tr_hdr_map.size(),
+        static_cast<size_t>(std::max(
+            in.binary_header().max_num_add_tr_headers, 0)) + 1);
+}
+
+void SEGYSplitter::Impl::encode(Trace::Header const& hdr, char* buf)
+{
+    int32_t endianness = in.binary_header().endianness;
+    std::memset(buf, 0, hdrs_num * CommonSEGY::TR_HEADER_SIZE);
+    for (size_t i = 0; i < hdrs_num; ++i)
+        for (auto& p : tr_hdr_map[i].second)
+            if (auto v = hdr.get(p.second.first))
+                CommonSEGY::write_header_value(
+                    buf + i * CommonSEGY::TR_HEADER_SIZE + p.first,
+                    p.second.second, *v, endianness);
+}
+
+Trace::Header SEGYSplitter::Impl::decode(char const* buf)
+{
+    int32_t endianness = in.binary_header().endianness;
+    unordered_map<string, Trace::Header::Value> hdr;
+    for (size_t i = 0; i < hdrs_num; ++i)
+        for (auto& p : tr_hdr_map[i].second)
+            hdr[p.second.first] = CommonSEGY::read_header_value(
+                buf + i * CommonSEGY::TR_HEADER_SIZE + p.first,
+                p.second.second, endianness);
+    return Trace::Header(move(hdr));
+}
+
+void SEGYSplitter::Impl::open(string const& name, Output& out)
+{
+    if (out.writer) {
+        lru.splice(lru.begin(), lru, out.lru_pos);
+        return;
+    }
+    if (lru.size() >= max_open) {
+        outputs[lru.back()].writer.reset();
+        lru.pop_back();
+    }
+    CommonSEGY::BinaryHeader bh = in.binary_header();
+    if (out.created) {
+        if (bh.SEGY_rev_major_ver > 1)
+            out.writer = make_unique<OSEGYRev2>(name, OSEGY::Append(),
+                                                tr_hdr_map);
+        else
+            out.writer = make_unique<OSEGYRev1>(name, OSEGY::Append(),
+                                                tr_hdr_map);
+    } else {
+        // number of traces is set when all of them are written
+        bh.num_of_tr_in_file = 0;
+        bh.num_of_trailer_stanza = 0;
+        if (bh.SEGY_rev_major_ver > 1)
+            out.writer = make_unique<OSEGYRev2>(name, in.text_headers(), bh,
+                                                vector<string>(), tr_hdr_map);
+        else
+            out.writer = make_unique<OSEGYRev1>(name, in.text_headers(), bh,
+                                                tr_hdr_map);
+        out.created = true;
+    }
+    lru.push_front(name);
+    out.lru_pos = lru.begin();
+}
+
+void SEGYSplitter::Impl::flush(string const& name, Output& out)
+{
+    open(name, out);
+    CommonSEGY::BinaryHeader const& bh = in.binary_header();
+    for (auto& p : out.pending)
+        out.writer->write_raw_trace(decode(p.first.data()), p.second,
+                                    bh.format_code, bh.endianness);
+    out.pending.clear();
+    buffered -= out.pending_size;
+    out.pending_size = 0;
+}
+
+void SEGYSplitter::Impl::set_traces_number(string const& name, uint64_t num)
+{
+    fstream fl;
+    fl.exceptions(fstream::failbit | fstream::badbit);
+    fl.open(name, fstream::in | fstream::out | fstream::binary);
+    char buf[CommonSEGY::BIN_HEADER_SIZE];
+    fl.seekg(CommonSEGY::TEXT_HEADER_SIZE);
+    fl.read(buf, CommonSEGY::BIN_HEADER_SIZE);
+    CommonSEGY::BinaryHeader bh = CommonSEGY::parse_binary_header(buf);
+    bh.num_of_tr_in_file = num;
+    CommonSEGY::format_binary_header(bh, buf);
+    fl.seekp(CommonSEGY::TEXT_HEADER_SIZE);
+    fl.write(buf, CommonSEGY::BIN_HEADER_SIZE);
+}
+
+SEGYSplitter::SEGYSplitter(string name, string key,
+                           function<string(Trace::Header::Value const&)>
+                               output_name,
+                           size_t max_open, size_t memory_budget,
+                           vector<pair<string, map<uint32_t,
+                                    pair<string, Trace::Header::ValueType>>>>
+                               hdr_map)
+    : pimpl { make_unique<Impl>(move(name), move(key), move(output_name),
+                                max_open, memory_budget, move(hdr_map)) }
+{
+}
+
+map<string, uint64_t> SEGYSplitter::split()
+{
+    vector<char> samples;
+    while (pimpl->in.has_trace()) {
+        Trace::Header hdr = pimpl->in.read_raw_trace(samples);
+        auto v = hdr.get(pimpl->key);
+        if (!v)
+            throw Exception(__FILE__, __LINE__,
+                            "trace has no " + pimpl->key + " value");
+        string name = pimpl->output_name(*v);
+        Impl::Output& out = pimpl->outputs[name];
+        vector<char> raw(pimpl->hdrs_num * CommonSEGY::TR_HEADER_SIZE);
+        pimpl->encode(hdr, raw.data());
+        size_t size = raw.size() + samples.size();
+        out.pending.emplace_back(move(raw), samples);
+        out.pending_size += size;
+        ++out.traces;
+        pimpl->buffered += size;
+        while (pimpl->buffered > pimpl->memory_budget) {
+            // the biggest buffer gives the biggest write
+            auto biggest = pimpl->outputs.begin();
+            for (auto it = pimpl->outputs.begin(); it != pimpl->outputs.end();
+                 ++it)
+                if (it->second.pending_size > biggest->second.pending_size)
+                    biggest = it;
+            pimpl->flush(biggest->first, biggest->second);
+        }
+    }
+    map<string, uint64_t> result;
+    for (auto& p : pimpl->outputs) {
+        if (p.second.pending_size)
+            pimpl->flush(p.first, p.second);
+        result[p.first] = p.second.traces;
+    }
+    for (auto& p : pimpl->outputs)
+        p.second.writer.reset();
+    pimpl->lru.clear();
+    if (pimpl->in.binary_header().SEGY_rev_major_ver > 1)
+        for (auto& p : result)
+            pimpl->set_traces_number(p.first, p.second);
+    return result;
+}
+
+SEGYSplitter::~SEGYSplitter() = default;
+} // namespace sedaman
@@ -0,0 +1,145 @@
+#include "SEGYTee.hpp"
+#include <functional>
+#include <optional>
+
+using std::function;
+using std::make_unique;
+using std::move;
+using std::optional;
+using std::unique_ptr;
+using std::vector;
+
+namespace sedaman {
+class SEGYTee::Impl {
+public:
+    Impl(vector<unique_ptr<OSEGY>> outs);
+    vector<unique_ptr<OSEGY>> outputs;
+    // writer whose encoded traces are written by this one
+    vector<optional<size_t>> source;
+    // writer whose encoded trace headers are copied by this one
+    vector<optional<size_t>> header_source;
+    // encoded traces of writers shared by others and offsets of trace
+    // headers in them
+    vector<vector<char>> encoded;
+    vector<vector<size_t>> offsets;
+    vector<char> shared;
+    bool grouped = false;
+    // copy of written bytes is kept only during write
+    class Capture {
+    public:
+        Capture(OSEGY& o, vector<char>* buf, vector<size_t>* hdrs)
+            : out { o }
+        {
+            buf->clear();
+            hdrs->clear();
+            out.capture_to(buf, hdrs);
+        }
+        ~Capture() { out.capture_to(nullptr, nullptr); }
+
+    private:
+        OSEGY& out;
+    };
+    class Headers {
+    public:
+        Headers(OSEGY& o, vector<char> const* buf,
+                vector<size_t> const* offs)
+            : out { o }
+        {
+            out.share_headers(buf, offs);
+        }
+        ~Headers() { out.share_headers(nullptr, nullptr); }
+
+    private:
+        OSEGY& out;
+    };
+    void group();
+    void write(function<void(OSEGY&)> const& func, uint64_t traces);
+};
+
+SEGYTee::Impl::Impl(vector<unique_ptr<OSEGY>> outs)
+    : outputs { move(outs) }
+    , source(outputs.size())
+    , header_source(outputs.size())
+    , encoded(outputs.size())
+    , offsets(outputs.size())
+    , shared(outputs.size())
+{
+}
+
+void SEGYTee::Impl::group()
+{
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        for (size_t k = 0; k < i; ++k)
+            if (!source[k] && outputs[i]->same_encoding(*outputs[k])) {
+                source[i] = k;
+                shared[k] = 1;
+                break;
+            }
+        if (source[i])
+            continue;
+        // only samples are encoded, e.g. for quantized copy
+        for (size_t k = 0; k < i; ++k)
+            if (!source[k] && outputs[i]->same_headers(*outputs[k])) {
+                header_source[i] = k;
+                shared[k] = 1;
+                break;
+            }
+    }
+    grouped = true;
+}
+
+void SEGYTee::Impl::write(function<void(OSEGY&)> const& func,
+                          uint64_t traces)
+{
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        OSEGY& out = *outputs[i];
+        if (source[i]) {
+            out.write_encoded(encoded[*source[i]], traces);
+            continue;
+        }
+        optional<Capture> c;
+        if (shared[i])
+            c.emplace(out, &encoded[i], &offsets[i]);
+        optional<Headers> h;
+        if (header_source[i])
+            h.emplace(out, &encoded[*header_source[i]],
+                      &offsets[*header_source[i]]);
+        func(out);
+    }
+}
+
+SEGYTee::SEGYTee(vector<unique_ptr<OSEGY>> outputs)
+    : pimpl { make_unique<Impl>(move(outputs)) }
+{
+}
+
+void SEGYTee::write_trace(Trace& tr)
+{
+    pimpl->write([&tr](OSEGY& out) { out.write_trace(tr); }, 1);
+    if (!pimpl->grouped)
+        pimpl->group();
+}
+
+void SEGYTee::write_traces(vector<Trace>& traces)
+{
+    if (traces.empty())
+        return;
+    std::span<Trace> rest(traces);
+    if (!pimpl->grouped) {
+        // first trace shows which writers encode the same way
+        write_trace(traces[0]);
+        rest = rest.subspan(1);
+        if (rest.empty())
+            return;
+    }
+    pimpl->write([rest](OSEGY& out) { out.write_batch(rest); }, rest.size());
+}
+
+OSEGY& SEGYTee::output(size_t i) { return *pimpl->outputs.at(i); }
+
+SEGYTee::~SEGYTee()
+{
+    for (auto& out : pimpl->outputs)
+        out.reset();
+}
+} // namespace sedaman
@@ -0,0 +1,174 @@
+#include "SpatialIndex.hpp"
+#include "Exception.hpp"
+#include <algorithm>
+
+using std::holds_alternative;
+using std::max;
+using std::min;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace sedaman {
+class SpatialIndex::Impl {
+public:
+    class Point {
+    public:
+        double c[2];
+        uint64_t trc;
+    };
+    // coordinates in file order
+    vector<double> xs;
+    vector<double> ys;
+    // implicit k-d tree, median of every range splits it by X on even
+    // levels and by Y on odd ones
+    vector<Point> tree;
+    void build(uint64_t lo, uint64_t hi, int axis);
+    template <typename F>
+    void query(uint64_t lo, uint64_t hi, int axis, double const box[4],
+               F const& inside, vector<uint64_t>& result);
+    template <typename F>
+    vector<uint64_t> query(double const box[4], F const& inside);
+};
+
+static double as_double(Trace::Header::Value v)
+{
+    return holds_alternative<int64_t>(v) ? std::get<int64_t>(v)
+                                         : std::get<double>(v);
+}
+
+void SpatialIndex::Impl::build(uint64_t lo, uint64_t hi, int axis)
+{
+    if (hi - lo < 2)
+        return;
+    uint64_t mid = lo + (hi - lo) / 2;
+    std::nth_element(tree.begin() + lo, tree.begin() + mid,
+                     tree.begin() + hi, [axis](Point const& a, Point const& b) {
+                         return a.c[axis] < b.c[axis];
+                     });
+    build(lo, mid, !axis);
+    build(mid + 1, hi, !axis);
+}
+
+template <typename F>
+void SpatialIndex::Impl::query(uint64_t lo, uint64_t hi, int axis,
+                               double const box[4], F const& inside,
+                               vector<uint64_t>& result)
+{
+    if (lo >= hi)
+        return;
+    uint64_t mid = lo + (hi - lo) / 2;
+    Point const& p = tree[mid];
+    if (p.c[0] >= box[0] && p.c[0] <= box[2] && p.c[1] >= box[1] &&
+        p.c[1] <= box[3] && inside(p.c[0], p.c[1]))
+        result.push_back(p.trc);
+    if (box[axis] <= p.c[axis])
+        query(lo, mid, !axis, box, inside, result);
+    if (box[axis + 2] >= p.c[axis])
+        query(mid + 1, hi, !axis, box, inside, result);
+}
+
+template <typename F>
+vector<uint64_t> SpatialIndex::Impl::query(double const box[4],
+                                           F const& inside)
+{
+    vector<uint64_t> result;
+    query(0, tree.size(), 0, box, inside, result);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+SpatialIndex::SpatialIndex(ISEGY& segy, string x_name, string y_name,
+                           string scalar_name, unsigned threads)
+    : pimpl { std::make_unique<Impl>() }
+{
+    auto x_off = segy.raw_header_offset(x_name);
+    auto y_off = segy.raw_header_offset(y_name);
+    if (!x_off || !y_off)
+        throw Exception(__FILE__, __LINE__, "no such header in trace");
+    auto sc_off = segy.raw_header_offset(scalar_name);
+    int32_t endianness = segy.binary_header().endianness;
+    uint64_t num = segy.traces_count();
+    pimpl->xs.resize(num);
+    pimpl->ys.resize(num);
+    segy.read_raw_headers([&](unsigned, uint64_t i, char const* hdr) {
+        double x = as_double(CommonSEGY::read_header_value(
+            hdr + x_off->first, x_off->second, endianness));
+        double y = as_double(CommonSEGY::read_header_value(
+            hdr + y_off->first, y_off->second, endianness));
+        if (sc_off) {
+            double scalar = as_double(CommonSEGY::read_header_value(
+                hdr + sc_off->first, sc_off->second, endianness));
+            if (scalar > 0) {
+                x *= scalar;
+                y *= scalar;
+            } else if (scalar < 0) {
+                x /= -scalar;
+                y /= -scalar;
+            }
+        }
+        pimpl->xs[i] = x;
+        pimpl->ys[i] = y;
+    }, threads);
+    pimpl->tree.resize(num);
+    for (uint64_t i = 0; i < num; ++i)
+        pimpl->tree[i] = { { pimpl->xs[i], pimpl->ys[i] }, i };
+    pimpl->build(0, num, 0);
+}
+
+uint64_t SpatialIndex::size() { return pimpl->tree.size(); }
+
+pair<double, double> SpatialIndex::coordinates(uint64_t num)
+{
+    if (num >= pimpl->xs.size())
+        throw Exception(__FILE__, __LINE__, "no such trace in index");
+    return { pimpl->xs[num], pimpl->ys[num] };
+}
+
+vector<uint64_t> SpatialIndex::query_bbox(double x_min, double y_min,
+                                          double x_max, double y_max)
+{
+    double box[4] = { x_min, y_min, x_max, y_max };
+    return pimpl->query(box, [](double, double) { return true; });
+}
+
+vector<uint64_t> SpatialIndex::query_radius(double x, double y, double r)
+{
+    double box[4] = { x - r, y - r, x + r, y + r };
+    return pimpl->query(box, [x, y, r](double px, double py) {
+        return (px - x) * (px - x) + (py - y) * (py - y) <= r * r;
+    });
+}
+
+vector<uint64_t>
+SpatialIndex::query_polygon(vector<pair<double, double>> const& polygon)
+{
+    if (polygon.size() < 3)
+        throw Exception(__FILE__, __LINE__,
+                        "polygon should have at least 3 vertices");
+    double box[4] = { polygon[0].first, polygon[0].second, polygon[0].first,
+                      polygon[0].second };
+    for (auto& v : polygon) {
+        box[0] = min(box[0], v.first);
+        box[1] = min(box[1], v.second);
+        box[2] = max(box[2], v.first);
+        box[3] = max(box[3], v.second);
+    }
+    // even-odd rule
+    return pimpl->query(box, [&polygon](double px, double py) {
+        bool in = false;
+        for (decltype(polygon.size()) i = 0, j = polygon.size() - 1;
+             i < polygon.size(); j = i++) {
+            auto& a = polygon[i];
+            auto& b = polygon[j];
+            if ((a.second > py) != (b.second > py) &&
+                px < (b.first - a.first) * (py - a.second) /
+                            (b.second - a.second) + a.first)
+                in = !in;
+        }
+        return in;
+    });
+}
+
+SpatialIndex::~SpatialIndex() = default;
+} // namespace sedaman
@@ -56,6 +56,13 @@ vector<string> Trace::Header::keys() const
     return result;
 }
 
+void Trace::Header::for_each(
+    std::function<void(string const&, Value const&)> func) const
+{
+    for (auto& p : pimpl->d_hdr)
+        func(p.first, p.second);
+}
+
 Trace::Header::Header(Header const& hdr)
     : pimpl { make_unique<Impl>(hdr.pimpl->d_hdr) }
 {
@@ -103,6 +110,11 @@ Trace::Trace(unordered_map<string, Header::Value> hdr, vector<double> s)
 {
 }
 
+Trace::Trace(Header hdr, vector<double> s)
+    : pimpl { make_unique<Impl>(move(hdr), move(s)) }
+{
+}
+
 Trace::~Trace() = default;
 
 Trace& Trace::operator=(Trace const& o)
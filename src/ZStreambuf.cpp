@@ -0,0 +1,451 @@
+#include "ZStreambuf.hpp"
+#include "Exception.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <zlib.h>
+
+using std::fstream;
+using std::ios_base;
+using std::lock_guard;
+using std::make_shared;
+using std::make_unique;
+using std::min;
+using std::move;
+using std::mutex;
+using std::optional;
+using std::pair;
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace sedaman {
+static char const idx_magic[8] = { 'S', 'D', 'M', 'N', 'Z', 'I', 'D', 'X' };
+static uint32_t constexpr idx_version = 1;
+// written in native byte order, used to detect files from other hosts
+static uint32_t constexpr idx_endianness = 0x01020304;
+// deflate window, the most distant back reference
+static uint32_t constexpr WIN = 32768;
+static uint32_t constexpr CHUNK = 256 * 1024;
+
+namespace {
+struct Point {
+    // position in output and input, number of bits of input byte before in
+    // which belong to this point
+    uint64_t out;
+    uint64_t in;
+    int bits;
+    vector<unsigned char> window;
+};
+
+// shared between clones of buffer
+struct Points {
+    mutex m;
+    vector<Point> pts;
+    optional<uint64_t> size;
+    uint64_t span;
+    uint64_t file_size;
+    bool gzip;
+};
+
+shared_ptr<Points> make_points(string const& file_name, uint64_t span)
+{
+    auto p = make_shared<Points>();
+    p->span = std::max<uint64_t>(span, WIN);
+    p->file_size = std::filesystem::file_size(file_name);
+    fstream fl(file_name, fstream::in | fstream::binary);
+    // otherwise zlib wrapper
+    p->gzip = fl.get() == 0x1f;
+    return p;
+}
+
+template <typename T> void put(fstream& fl, T v)
+{
+    fl.write(reinterpret_cast<char const*>(&v), sizeof(T));
+}
+
+template <typename T> T get(fstream& fl)
+{
+    T v;
+    fl.read(reinterpret_cast<char*>(&v), sizeof(T));
+    return v;
+}
+} // namespace
+
+class ZStreambuf::Impl {
+public:
+    Impl(string name, shared_ptr<Points> p);
+    ~Impl() { inflateEnd(&strm); }
+    string file_name;
+    shared_ptr<Points> points;
+    fstream file;
+    z_stream strm;
+    // inflate started from seek point knows nothing about gzip wrapper
+    bool raw = false;
+    bool at_end = false;
+    vector<unsigned char> in_buf;
+    // circular buffer, the last WIN bytes of output are always here
+    vector<unsigned char> out_buf;
+    // file offset of the next input read
+    uint64_t in_pos = 0;
+    // output offset of the current get area start
+    uint64_t pos = 0;
+    uint64_t last_point = 0;
+    pair<char*, char*> produce();
+    void restart(uint64_t target);
+    void load_index();
+    void save_index();
+
+private:
+    bool fill_input();
+    void skip_input(uint32_t n);
+    void next_member();
+    void add_point();
+};
+
+ZStreambuf::Impl::Impl(string name, shared_ptr<Points> p)
+    : file_name { move(name) }
+    , points { move(p) }
+    , strm {}
+    , in_buf(CHUNK)
+    , out_buf(WIN)
+{
+    file.exceptions(fstream::badbit);
+    file.open(file_name, fstream::in | fstream::binary);
+    if (!file)
+        throw Exception(__FILE__, __LINE__, "unable to open " + file_name);
+    // 15 bits window, 32 for gzip and zlib header detection
+    if (inflateInit2(&strm, 47) != Z_OK)
+        throw Exception(__FILE__, __LINE__, "inflate initialization failed");
+    strm.next_out = out_buf.data();
+    strm.avail_out = WIN;
+}
+
+bool ZStreambuf::Impl::fill_input()
+{
+    file.read(reinterpret_cast<char*>(in_buf.data()), in_buf.size());
+    uint64_t n = file.gcount();
+    file.clear();
+    in_pos += n;
+    strm.next_in = in_buf.data();
+    strm.avail_in = n;
+    return n;
+}
+
+void ZStreambuf::Impl::skip_input(uint32_t n)
+{
+    while (n) {
+        if (!strm.avail_in && !fill_input())
+            throw Exception(__FILE__, __LINE__,
+                            "unexpected end of compressed file");
+        uint32_t k = min(n, strm.avail_in);
+        strm.next_in += k;
+        strm.avail_in -= k;
+        n -= k;
+    }
+}
+
+void ZStreambuf::Impl::next_member()
+{
+    // without wrapper inflate leaves check value unread
+    if (raw)
+        skip_input(points->gzip ? 8 : 4);
+    if (!strm.avail_in && !fill_input()) {
+        at_end = true;
+        lock_guard<mutex> lock(points->m);
+        points->size = pos;
+        return;
+    }
+    // concatenated gzip members
+    inflateReset2(&strm, 47);
+    raw = false;
+}
+
+void ZStreambuf::Impl::add_point()
+{
+    lock_guard<mutex> lock(points->m);
+    uint64_t out = pos;
+    if (out < WIN || out < last_point + points->span ||
+        (!points->pts.empty() && out <= points->pts.back().out))
+        return;
+    Point p;
+    p.out = out;
+    p.in = in_pos - strm.avail_in;
+    p.bits = strm.data_type & 7;
+    p.window.resize(WIN);
+    size_t have = strm.next_out - out_buf.data();
+    memcpy(p.window.data(), out_buf.data() + have, WIN - have);
+    memcpy(p.window.data() + WIN - have, out_buf.data(), have);
+    points->pts.push_back(move(p));
+    last_point = out;
+}
+
+pair<char*, char*> ZStreambuf::Impl::produce()
+{
+    if (!strm.avail_out) {
+        strm.next_out = out_buf.data();
+        strm.avail_out = WIN;
+    }
+    unsigned char* start = strm.next_out;
+    while (!at_end && strm.next_out == start) {
+        if (!strm.avail_in)
+            fill_input();
+        // stop at block boundaries, only there seek point could be set
+        int ret = inflate(&strm, Z_BLOCK);
+        if (ret == Z_BUF_ERROR)
+            throw Exception(__FILE__, __LINE__,
+                            "unexpected end of compressed file");
+        if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR)
+            throw Exception(__FILE__, __LINE__,
+                            string("compressed data error: ") +
+                                (strm.msg ? strm.msg : file_name));
+        if (ret == Z_MEM_ERROR)
+            throw Exception(__FILE__, __LINE__, "out of memory");
+        uint64_t chunk_pos = pos;
+        pos += strm.next_out - start;
+        if (ret == Z_STREAM_END)
+            next_member();
+        else if ((strm.data_type & 128) && !(strm.data_type & 64))
+            add_point();
+        pos = chunk_pos;
+    }
+    return { reinterpret_cast<char*>(start),
+             reinterpret_cast<char*>(strm.next_out) };
+}
+
+void ZStreambuf::Impl::restart(uint64_t target)
+{
+    optional<Point> p;
+    {
+        lock_guard<mutex> lock(points->m);
+        auto it = std::upper_bound(points->pts.begin(), points->pts.end(),
+                                   target, [](uint64_t t, Point const& pt) {
+                                       return t < pt.out;
+                                   });
+        if (it != points->pts.begin())
+            p = *(it - 1);
+    }
+    file.clear();
+    strm.avail_in = 0;
+    at_end = false;
+    strm.next_out = out_buf.data();
+    strm.avail_out = WIN;
+    if (!p) {
+        file.seekg(0);
+        in_pos = 0;
+        inflateReset2(&strm, 47);
+        raw = false;
+        pos = 0;
+        last_point = 0;
+        return;
+    }
+    in_pos = p->in - (p->bits ? 1 : 0);
+    file.seekg(in_pos);
+    inflateReset2(&strm, -15);
+    raw = true;
+    if (p->bits) {
+        char ch;
+        file.read(&ch, 1);
+        ++in_pos;
+        inflatePrime(&strm, p->bits,
+                     static_cast<unsigned char>(ch) >> (8 - p->bits));
+    }
+    inflateSetDictionary(&strm, p->window.data(), WIN);
+    // window is the whole history, next output starts new cycle
+    memcpy(out_buf.data(), p->window.data(), WIN);
+    pos = p->out;
+    last_point = p->out;
+}
+
+void ZStreambuf::Impl::load_index()
+{
+    string name = ZStreambuf::index_name(file_name);
+    if (!std::filesystem::exists(name))
+        return;
+    fstream fl;
+    fl.exceptions(fstream::failbit | fstream::badbit);
+    fl.open(name, fstream::in | fstream::binary);
+    char magic[sizeof(idx_magic)];
+    fl.read(magic, sizeof(magic));
+    if (memcmp(magic, idx_magic, sizeof(magic)) ||
+        get<uint32_t>(fl) != idx_version ||
+        get<uint32_t>(fl) != idx_endianness)
+        throw Exception(__FILE__, __LINE__, "wrong index file " + name);
+    // stale index of rewritten file is ignored
+    if (get<uint64_t>(fl) != points->file_size)
+        return;
+    uint64_t size = get<uint64_t>(fl);
+    uint64_t span = get<uint64_t>(fl);
+    uint64_t num = get<uint64_t>(fl);
+    vector<Point> pts(num);
+    for (Point& p : pts) {
+        p.out = get<uint64_t>(fl);
+        p.in = get<uint64_t>(fl);
+        p.bits = get<uint8_t>(fl);
+        p.window.resize(WIN);
+        fl.read(reinterpret_cast<char*>(p.window.data()), WIN);
+    }
+    points->pts = move(pts);
+    points->size = size;
+    points->span = span;
+}
+
+void ZStreambuf::Impl::save_index()
+{
+    fstream fl;
+    fl.exceptions(fstream::failbit | fstream::badbit);
+    fl.open(ZStreambuf::index_name(file_name),
+            fstream::out | fstream::binary | fstream::trunc);
+    lock_guard<mutex> lock(points->m);
+    fl.write(idx_magic, sizeof(idx_magic));
+    put(fl, idx_version);
+    put(fl, idx_endianness);
+    put(fl, points->file_size);
+    put(fl, *points->size);
+    put(fl, points->span);
+    put<uint64_t>(fl, points->pts.size());
+    for (Point const& p : points->pts) {
+        put(fl, p.out);
+        put(fl, p.in);
+        put<uint8_t>(fl, p.bits);
+        fl.write(reinterpret_cast<char const*>(p.window.data()), WIN);
+    }
+}
+
+bool ZStreambuf::is_compressed(string const& file_name)
+{
+    fstream fl;
+    fl.exceptions(fstream::badbit);
+    fl.open(file_name, fstream::in | fstream::binary);
+    unsigned char buf[2] = {};
+    fl.read(reinterpret_cast<char*>(buf), 2);
+    if (fl.gcount() != 2)
+        return false;
+    // only gzip magic, two bytes of zlib header are valid for too many
+    // plain text headers
+    return buf[0] == 0x1f && buf[1] == 0x8b;
+}
+
+string ZStreambuf::index_name(string const& file_name)
+{
+    return file_name + ".zidx";
+}
+
+void ZStreambuf::write_index(string const& file_name, uint64_t span)
+{
+    // existing index is not loaded, it could have other span
+    ZStreambuf buf(make_unique<Impl>(file_name,
+                                     make_points(file_name, span)));
+    if (buf.pubseekoff(0, ios_base::end, ios_base::in) == pos_type(-1))
+        throw Exception(__FILE__, __LINE__, "unable to index " + file_name);
+    buf.pimpl->save_index();
+}
+
+ZStreambuf::ZStreambuf(string const& file_name, uint64_t span)
+    : pimpl { make_unique<Impl>(file_name, make_points(file_name, span)) }
+{
+    pimpl->load_index();
+}
+
+ZStreambuf::ZStreambuf(unique_ptr<Impl> impl)
+    : pimpl { move(impl) }
+{
+}
+
+unique_ptr<ZStreambuf> ZStreambuf::clone() const
+{
+    return unique_ptr<ZStreambuf>(
+        new ZStreambuf(make_unique<Impl>(pimpl->file_name, pimpl->points)));
+}
+
+ZStreambuf::int_type ZStreambuf::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    pimpl->pos += egptr() - eback();
+    auto [b, e] = pimpl->produce();
+    setg(b, b, e);
+    return b == e ? traits_type::eof() : traits_type::to_int_type(*b);
+}
+
+ZStreambuf::pos_type ZStreambuf::seekoff(off_type off, ios_base::seekdir dir,
+                                         ios_base::openmode which)
+{
+    uint64_t cur = pimpl->pos + (gptr() - eback());
+    if (dir == ios_base::cur)
+        return off ? seekpos(cur + off, which) : pos_type(cur);
+    if (dir == ios_base::beg)
+        return seekpos(off, which);
+    optional<uint64_t> size;
+    {
+        lock_guard<mutex> lock(pimpl->points->m);
+        size = pimpl->points->size;
+    }
+    if (!size) {
+        // decompress till the end, seek points are remembered on the way
+        while (1) {
+            pimpl->pos += egptr() - eback();
+            auto [b, e] = pimpl->produce();
+            setg(b, e, e);
+            if (b == e)
+                break;
+        }
+        size = pimpl->pos;
+    }
+    return seekpos(*size + off, which);
+}
+
+ZStreambuf::pos_type ZStreambuf::seekpos(pos_type sp, ios_base::openmode)
+{
+    if (sp < 0)
+        return pos_type(off_type(-1));
+    uint64_t target = static_cast<off_type>(sp);
+    uint64_t cur = pimpl->pos + (gptr() - eback());
+    // inside get area
+    if (target >= pimpl->pos &&
+        target <= pimpl->pos + static_cast<uint64_t>(egptr() - eback())) {
+        setg(eback(), eback() + (target - pimpl->pos), egptr());
+        return sp;
+    }
+    bool restart = target < cur;
+    if (!restart) {
+        // nearer seek point is cheaper than decompressing from here
+        lock_guard<mutex> lock(pimpl->points->m);
+        auto& pts = pimpl->points->pts;
+        auto it = std::upper_bound(pts.begin(), pts.end(), target,
+                                   [](uint64_t t, Point const& pt) {
+                                       return t < pt.out;
+                                   });
+        restart = it != pts.begin() && (it - 1)->out > cur;
+    }
+    if (restart) {
+        pimpl->restart(target);
+        setg(nullptr, nullptr, nullptr);
+    }
+    while (1) {
+        pimpl->pos += egptr() - eback();
+        auto [b, e] = pimpl->produce();
+        setg(b, b, e);
+        if (target <= pimpl->pos + static_cast<uint64_t>(e - b)) {
+            setg(b, b + (target - pimpl->pos), e);
+            return sp;
+        }
+        if (b == e)
+            return pos_type(off_type(-1));
+    }
+}
+
+ZStreambuf::~ZStreambuf() = default;
+
+ZIStream::ZIStream(unique_ptr<ZStreambuf> b)
+    : std::istream(nullptr)
+    , buf { std::move(b) }
+{
+    rdbuf(buf.get());
+}
+} // namespace sedaman
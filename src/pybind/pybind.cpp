@@ -1,7 +1,13 @@
+#include "BrickVolume.hpp"
+#include "Catalog.hpp"
 #include "CommonSEGD.hpp"
 #include "CommonSEGY.hpp"
+#include "HeaderStats.hpp"
 #include "ISEGD.hpp"
 #include "ISEGY.hpp"
+#include "ISEGY3D.hpp"
+#include "ISEGYDataset.hpp"
+#include "ISEGYFiltered.hpp"
 #include "ISEGYSorted1D.hpp"
 #include "OSEGD.hpp"
 #include "OSEGDRev2_1.hpp"
@@ -9,6 +15,12 @@
 #include "OSEGYRev0.hpp"
 #include "OSEGYRev1.hpp"
 #include "OSEGYRev2.hpp"
+#include "SEGYEditor.hpp"
+#include "SEGYMerger.hpp"
+#include "SEGYSplitter.hpp"
+#include "SpatialIndex.hpp"
+#include "ZStreambuf.hpp"
+#include "pybind11/functional.h"
 #include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
@@ -67,6 +79,8 @@ PYBIND11_MODULE(pysedaman, m) {
                                     &CommonSEGY::TEXT_HEADER_SIZE);
   CommonSEGY_py.def_readonly_static("TR_HEADER_SIZE",
                                     &CommonSEGY::TR_HEADER_SIZE);
+  CommonSEGY_py.def_readonly_static("NATIVE_ENDIANNESS",
+                                    &CommonSEGY::NATIVE_ENDIANNESS);
   CommonSEGY_py.def_readonly_static("trace_header_description",
                                     &CommonSEGY::trace_header_description);
   CommonSEGY_py.def_readonly_static("default_trace_header",
@@ -204,6 +218,22 @@ PYBIND11_MODULE(pysedaman, m) {
   ISEGY_py.def("read_header", &ISEGY::read_header,
                "reads header, skips samples");
   ISEGY_py.def("read_trace", &ISEGY::read_trace, "reads one trace from file");
+  ISEGY_py.def(
+      "read_raw_trace",
+      [](ISEGY &s) {
+        vector<char> samples;
+        Trace::Header hdr = s.read_raw_trace(samples);
+        return py::make_tuple(std::move(hdr),
+                              py::bytes(samples.data(), samples.size()));
+      },
+      "reads header and raw samples of next trace");
+  ISEGY_py.def("traces_count", &ISEGY::traces_count,
+               "returns number of traces in file");
+  ISEGY_py.def("seek_trace", &ISEGY::seek_trace,
+               "moves to trace with given number", py::arg("num"));
+  ISEGY_py.def("extract_traces", &ISEGY::extract_traces,
+               "writes new file with given traces of this file",
+               py::arg("file_name"), py::arg("traces"));
   ISEGY_py.def("__next__", [](ISEGY &s) {
     return s.has_trace() ? s.read_trace() : throw py::stop_iteration();
   });
@@ -239,9 +269,270 @@ PYBIND11_MODULE(pysedaman, m) {
   });
   ISEGYSorted1D_py.def("__iter__", [](ISEGYSorted1D &s) { return &s; });
 
+  py::class_<ISEGYDataset> ISEGYDataset_py(m, "ISEGYDataset");
+  ISEGYDataset_py.def(
+      py::init<
+          vector<string>,
+          vector<pair<string, map<uint32_t,
+                                  pair<string, Trace::Header::ValueType>>>>,
+          unsigned>(),
+      py::arg("file_names"),
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header,
+      py::arg("threads") = 0);
+  ISEGYDataset_py.def("files_count", &ISEGYDataset::files_count,
+                      "number of files in dataset");
+  ISEGYDataset_py.def("file_name", &ISEGYDataset::file_name, "name of file",
+                      py::arg("file"));
+  ISEGYDataset_py.def("binary_header", &ISEGYDataset::binary_header,
+                      "binary header of file", py::arg("file"));
+  ISEGYDataset_py.def("traces_count", &ISEGYDataset::traces_count,
+                      "total number of traces in all files");
+  ISEGYDataset_py.def("locate", &ISEGYDataset::locate,
+                      "finds file with trace", py::arg("num"));
+  ISEGYDataset_py.def("seek_trace", &ISEGYDataset::seek_trace,
+                      "moves to trace with given global number",
+                      py::arg("num"));
+  ISEGYDataset_py.def("has_trace", &ISEGYDataset::has_trace,
+                      "checks for next trace in dataset");
+  ISEGYDataset_py.def("read_header", &ISEGYDataset::read_header,
+                      "reads header, skips samples");
+  ISEGYDataset_py.def("read_trace", &ISEGYDataset::read_trace,
+                      "reads one trace");
+  ISEGYDataset_py.def("header_values", &ISEGYDataset::header_values,
+                      "collects value of trace header for every trace",
+                      py::arg("name"), py::arg("threads") = 0);
+  ISEGYDataset_py.def("__next__", [](ISEGYDataset &s) {
+    return s.has_trace() ? s.read_trace() : throw py::stop_iteration();
+  });
+  ISEGYDataset_py.def("__iter__", [](ISEGYDataset &s) { return &s; });
+
+  py::class_<ISEGYFiltered, ISEGY> ISEGYFiltered_py(m, "ISEGYFiltered");
+  ISEGYFiltered_py.def(
+      py::init<
+          string, string const &,
+          vector<pair<string, map<uint32_t,
+                                  pair<string, Trace::Header::ValueType>>>>>(),
+      py::arg("file_name"), py::arg("expression"),
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
+  ISEGYFiltered_py.def(
+      py::init<
+          string, string const &, CommonSEGY::BinaryHeader,
+          vector<pair<string, map<uint32_t,
+                                  pair<string, Trace::Header::ValueType>>>>>(),
+      py::arg("file_name"), py::arg("expression"), py::arg("binary_header"),
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
+  ISEGYFiltered_py.def("has_trace", &ISEGYFiltered::has_trace,
+                       "checks for next matching trace in file");
+  ISEGYFiltered_py.def("read_header", &ISEGYFiltered::read_header,
+                       "reads header of next matching trace");
+  ISEGYFiltered_py.def("read_trace", &ISEGYFiltered::read_trace,
+                       "reads next matching trace");
+  ISEGYFiltered_py.def("selected", &ISEGYFiltered::selected,
+                       "ordinal numbers of all matching traces",
+                       py::arg("threads") = 0);
+  ISEGYFiltered_py.def("__next__", [](ISEGYFiltered &s) {
+    return s.has_trace() ? s.read_trace() : throw py::stop_iteration();
+  });
+  ISEGYFiltered_py.def("__iter__", [](ISEGYFiltered &s) { return &s; });
+
+  py::class_<ISEGY3D, ISEGY> ISEGY3D_py(m, "ISEGY3D");
+  ISEGY3D_py.def(
+      py::init<
+          string, string, string,
+          vector<pair<string, map<uint32_t,
+                                  pair<string, Trace::Header::ValueType>>>>>(),
+      py::arg("file_name"), py::arg("il_name") = "INLINE",
+      py::arg("xl_name") = "XLINE",
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
+  ISEGY3D_py.def(
+      py::init<
+          string, CommonSEGY::BinaryHeader, string, string,
+          vector<pair<string, map<uint32_t,
+                                  pair<string, Trace::Header::ValueType>>>>>(),
+      py::arg("file_name"), py::arg("binary_header"),
+      py::arg("il_name") = "INLINE", py::arg("xl_name") = "XLINE",
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
+  ISEGY3D_py.def("grid", &ISEGY3D::grid, "grid getter");
+  ISEGY3D_py.def("samples_per_trace", &ISEGY3D::samples_per_trace,
+                 "number of samples in every trace of volume");
+  ISEGY3D_py.def("trace_exists", &ISEGY3D::trace_exists,
+                 "checks if there is a trace at grid node", py::arg("il"),
+                 py::arg("xl"));
+  ISEGY3D_py.def("get_trace", &ISEGY3D::get_trace, "reads trace at grid node",
+                 py::arg("il"), py::arg("xl"));
+  ISEGY3D_py.def(
+      "inline_section",
+      [](ISEGY3D &s, int64_t il) {
+        return py::array_t<double>(
+            {s.grid().xl_num, static_cast<uint64_t>(s.samples_per_trace())},
+            s.inline_section(il).data());
+      },
+      "reads samples of all traces of inline", py::arg("il"));
+  ISEGY3D_py.def(
+      "crossline_section",
+      [](ISEGY3D &s, int64_t xl) {
+        return py::array_t<double>(
+            {s.grid().il_num, static_cast<uint64_t>(s.samples_per_trace())},
+            s.crossline_section(xl).data());
+      },
+      "reads samples of all traces of crossline", py::arg("xl"));
+  ISEGY3D_py.def(
+      "time_slice",
+      [](ISEGY3D &s, uint32_t sample) {
+        return py::array_t<double>({s.grid().il_num, s.grid().xl_num},
+                                   s.time_slice(sample).data());
+      },
+      "reads one sample from every trace", py::arg("sample"));
+  ISEGY3D_py.def("read_cube", &ISEGY3D::read_cube,
+                 "loads whole volume into memory", py::arg("threads") = 0);
+  py::class_<ISEGY3D::Grid> Grid_py(ISEGY3D_py, "Grid");
+  Grid_py.def_readonly("il_first", &ISEGY3D::Grid::il_first);
+  Grid_py.def_readonly("il_step", &ISEGY3D::Grid::il_step);
+  Grid_py.def_readonly("il_num", &ISEGY3D::Grid::il_num);
+  Grid_py.def_readonly("xl_first", &ISEGY3D::Grid::xl_first);
+  Grid_py.def_readonly("xl_step", &ISEGY3D::Grid::xl_step);
+  Grid_py.def_readonly("xl_num", &ISEGY3D::Grid::xl_num);
+  Grid_py.def_readonly("missing", &ISEGY3D::Grid::missing);
+  py::class_<ISEGY3D::Cube> Cube_py(ISEGY3D_py, "Cube");
+  Cube_py.def_readonly("grid", &ISEGY3D::Cube::grid);
+  Cube_py.def_readonly("samp_num", &ISEGY3D::Cube::samp_num);
+  Cube_py.def_property_readonly(
+      "samples",
+      [](py::object self) {
+        ISEGY3D::Cube &c = self.cast<ISEGY3D::Cube &>();
+        return py::array_t<float>({c.grid.il_num, c.grid.xl_num,
+                                   static_cast<uint64_t>(c.samp_num)},
+                                  c.samples.data(), self);
+      },
+      "samples in [inline][crossline][sample] order without copying");
+  Cube_py.def_property_readonly(
+      "mask",
+      [](py::object self) {
+        ISEGY3D::Cube &c = self.cast<ISEGY3D::Cube &>();
+        return py::array_t<uint8_t>({c.grid.il_num, c.grid.xl_num},
+                                    c.mask.data(), self);
+      },
+      "live trace flags in [inline][crossline] order");
+
+  py::class_<BrickVolume> BrickVolume_py(m, "BrickVolume");
+  BrickVolume_py.def(py::init<string>(), py::arg("file_name"));
+  BrickVolume_py.def_static(
+      "from_segy", &BrickVolume::from_segy,
+      "converts post stack SEGY to brick volume", py::arg("segy_name"),
+      py::arg("file_name"), py::arg("brick_il") = 64,
+      py::arg("brick_xl") = 64, py::arg("brick_smp") = 64,
+      py::arg("level") = 6, py::arg("il_name") = "INLINE",
+      py::arg("xl_name") = "XLINE", py::arg("threads") = 0);
+  BrickVolume_py.def("grid", &BrickVolume::grid, "grid getter");
+  BrickVolume_py.def("samples_per_trace", &BrickVolume::samples_per_trace,
+                     "number of samples in every trace of volume");
+  BrickVolume_py.def("binary_header", &BrickVolume::binary_header,
+                     "binary header of original SEGY");
+  BrickVolume_py.def(
+      "inline_section",
+      [](BrickVolume &s, int64_t il) {
+        return py::array_t<double>(
+            {s.grid().xl_num, static_cast<uint64_t>(s.samples_per_trace())},
+            s.inline_section(il).data());
+      },
+      "reads samples of all traces of inline", py::arg("il"));
+  BrickVolume_py.def(
+      "crossline_section",
+      [](BrickVolume &s, int64_t xl) {
+        return py::array_t<double>(
+            {s.grid().il_num, static_cast<uint64_t>(s.samples_per_trace())},
+            s.crossline_section(xl).data());
+      },
+      "reads samples of all traces of crossline", py::arg("xl"));
+  BrickVolume_py.def(
+      "time_slice",
+      [](BrickVolume &s, uint32_t sample) {
+        return py::array_t<double>({s.grid().il_num, s.grid().xl_num},
+                                   s.time_slice(sample).data());
+      },
+      "reads one sample from every trace", py::arg("sample"));
+  BrickVolume_py.def("to_segy", &BrickVolume::to_segy,
+                     "converts volume back to SEGY", py::arg("segy_name"));
+
+  py::class_<SpatialIndex> SpatialIndex_py(m, "SpatialIndex");
+  SpatialIndex_py.def(py::init<ISEGY &, string, string, string, unsigned>(),
+                      py::arg("segy"), py::arg("x_name") = "CDP_X",
+                      py::arg("y_name") = "CDP_Y",
+                      py::arg("scalar_name") = "COORD_SCALAR",
+                      py::arg("threads") = 0);
+  SpatialIndex_py.def("size", &SpatialIndex::size,
+                      "number of indexed traces");
+  SpatialIndex_py.def("coordinates", &SpatialIndex::coordinates,
+                      "coordinates of trace with scalar applied",
+                      py::arg("num"));
+  SpatialIndex_py.def("query_bbox", &SpatialIndex::query_bbox,
+                      "finds traces inside rectangle", py::arg("x_min"),
+                      py::arg("y_min"), py::arg("x_max"), py::arg("y_max"));
+  SpatialIndex_py.def("query_radius", &SpatialIndex::query_radius,
+                      "finds traces inside circle", py::arg("x"),
+                      py::arg("y"), py::arg("r"));
+  SpatialIndex_py.def("query_polygon", &SpatialIndex::query_polygon,
+                      "finds traces inside polygon", py::arg("polygon"));
+
+  py::class_<HeaderStats> HeaderStats_py(m, "HeaderStats");
+  HeaderStats_py.def_static(
+      "compute", &HeaderStats::compute,
+      "computes statistics for every value in trace header map",
+      py::arg("file_name"),
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header,
+      py::arg("bins") = 64, py::arg("threads") = 0);
+  HeaderStats_py.def_static("clear_cache", &HeaderStats::clear_cache,
+                            "drops all cached results");
+  py::class_<HeaderStats::Field> Field_py(HeaderStats_py, "Field");
+  Field_py.def_readonly("name", &HeaderStats::Field::name);
+  Field_py.def_readonly("count", &HeaderStats::Field::count);
+  Field_py.def_readonly("nonzero", &HeaderStats::Field::nonzero);
+  Field_py.def_readonly("min", &HeaderStats::Field::min);
+  Field_py.def_readonly("max", &HeaderStats::Field::max);
+  Field_py.def_readonly("mean", &HeaderStats::Field::mean);
+  Field_py.def_readonly("distinct", &HeaderStats::Field::distinct);
+  Field_py.def_readonly("bin_start", &HeaderStats::Field::bin_start);
+  Field_py.def_readonly("bin_width", &HeaderStats::Field::bin_width);
+  Field_py.def_readonly("histogram", &HeaderStats::Field::histogram);
+
   py::class_<OSEGY> OSEGY_py(m, "OSEGY");
   OSEGY_py.def("write_trace", &OSEGY::write_trace,
                "Writes trace to the end of file.", py::arg("trace"));
+  OSEGY_py.def("write_traces",
+               py::overload_cast<vector<Trace> &>(&OSEGY::write_traces),
+               "Writes batch of traces with one write call.",
+               py::arg("traces"));
+  OSEGY_py.def(
+      "write_traces",
+      py::overload_cast<vector<unordered_map<string, Trace::Header::Value>>,
+                        vector<double> const &>(&OSEGY::write_traces),
+      "Writes batch of traces with samples in one matrix [trace][sample].",
+      py::arg("headers"), py::arg("samples"));
+  OSEGY_py.def(
+      "write_raw_trace",
+      [](OSEGY &s, Trace::Header hdr, py::bytes samples, int16_t format_code,
+         int32_t endianness) {
+        string bytes = samples;
+        s.write_raw_trace(std::move(hdr),
+                          vector<char>(bytes.begin(), bytes.end()),
+                          format_code, endianness);
+      },
+      "Writes trace with raw samples, they are copied if format matches.",
+      py::arg("header"), py::arg("samples"), py::arg("format_code"),
+      py::arg("endianness"));
+  OSEGY_py.def("write_trace_at", &OSEGY::write_trace_at,
+               "Writes trace to given place of fixed length file.",
+               py::arg("num"), py::arg("trace"));
+  OSEGY_py.def("reserve_traces", &OSEGY::reserve_traces,
+               "Preallocates file for traces and writes them to its mapping.",
+               py::arg("num"));
+  py::enum_<OSEGY::Quantization>(OSEGY_py, "Quantization")
+      .value("none", OSEGY::Quantization::none)
+      .value("trace", OSEGY::Quantization::trace)
+      .value("file", OSEGY::Quantization::file);
+  OSEGY_py.def("set_quantization", &OSEGY::set_quantization,
+               "Sets scaling of samples for formats 3 and 8.", py::arg("mode"),
+               py::arg("weight_key") = "TRACE_WEIGHT");
 
   py::class_<OSEGYRev0, OSEGY> OSEGYRev0_py(m, "OSEGYRev0");
   OSEGYRev0_py.def(
@@ -262,6 +553,17 @@ PYBIND11_MODULE(pysedaman, m) {
       py::arg("file_name"), py::arg("text_headers") = vector<string>(),
       py::arg("bin_header") = CommonSEGY::BinaryHeader(),
       py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
+  OSEGYRev1_py.def_static(
+      "append",
+      [](string name,
+         vector<pair<string,
+                     map<uint32_t, pair<string, Trace::Header::ValueType>>>>
+             tr_hdr_map) {
+        return std::make_unique<OSEGYRev1>(std::move(name), OSEGY::Append(),
+                                           std::move(tr_hdr_map));
+      },
+      "Opens existing file to append traces.", py::arg("file_name"),
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
 
   py::class_<OSEGYRev2, OSEGY> OSEGYRev2_py(m, "OSEGYRev2");
   OSEGYRev2_py.def(
@@ -273,6 +575,69 @@ PYBIND11_MODULE(pysedaman, m) {
       py::arg("bin_header") = CommonSEGY::BinaryHeader(),
       py::arg("trailer_stanzas") = vector<string>(),
       py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
+  OSEGYRev2_py.def_static(
+      "append",
+      [](string name,
+         vector<pair<string,
+                     map<uint32_t, pair<string, Trace::Header::ValueType>>>>
+             tr_hdr_map) {
+        return std::make_unique<OSEGYRev2>(std::move(name), OSEGY::Append(),
+                                           std::move(tr_hdr_map));
+      },
+      "Opens existing file to append traces.", py::arg("file_name"),
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
+
+  py::class_<SEGYEditor> SEGYEditor_py(m, "SEGYEditor");
+  SEGYEditor_py.def(
+      py::init<
+          string,
+          vector<pair<string, map<uint32_t,
+                                  pair<string, Trace::Header::ValueType>>>>>(),
+      py::arg("file_name"),
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
+  SEGYEditor_py.def("binary_header", &SEGYEditor::binary_header,
+                    "returns binary header");
+  SEGYEditor_py.def("write_binary_header", &SEGYEditor::write_binary_header,
+                    "writes binary header to file", py::arg("bin_header"));
+  SEGYEditor_py.def("traces_count", &SEGYEditor::traces_count,
+                    "returns number of traces in file");
+  SEGYEditor_py.def("read_header", &SEGYEditor::read_header,
+                    "reads headers of trace", py::arg("num"));
+  SEGYEditor_py.def("write_header", &SEGYEditor::write_header,
+                    "writes values of header to trace", py::arg("num"),
+                    py::arg("header"));
+  SEGYEditor_py.def("edit_headers", &SEGYEditor::edit_headers,
+                    "passes headers of every trace to func and writes changes",
+                    py::arg("func"));
+
+  py::class_<SEGYSplitter> SEGYSplitter_py(m, "SEGYSplitter");
+  SEGYSplitter_py.def(
+      py::init<
+          string, string,
+          std::function<string(Trace::Header::Value const &)>, size_t,
+          size_t,
+          vector<pair<string, map<uint32_t,
+                                  pair<string, Trace::Header::ValueType>>>>>(),
+      py::arg("file_name"), py::arg("key"), py::arg("output_name"),
+      py::arg("max_open") = 64, py::arg("memory_budget") = 64 << 20,
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
+  SEGYSplitter_py.def("split", &SEGYSplitter::split,
+                      "reads input and writes all outputs");
+
+  py::class_<SEGYMerger> SEGYMerger_py(m, "SEGYMerger");
+  SEGYMerger_py.def(
+      py::init<
+          string, vector<string>,
+          vector<pair<string, map<uint32_t,
+                                  pair<string, Trace::Header::ValueType>>>>>(),
+      py::arg("file_name"), py::arg("renumber") = vector<string>(),
+      py::arg("tr_hdr_map") = CommonSEGY::default_trace_header);
+  SEGYMerger_py.def("add", &SEGYMerger::add,
+                    "appends all traces of file to output");
+  SEGYMerger_py.def("traces_count", &SEGYMerger::traces_count,
+                    "returns number of traces written so far");
+  SEGYMerger_py.def("close", &SEGYMerger::close,
+                    "completes binary header and closes output");
 
   py::class_<CommonSEGD> CommonSEGD_py(m, "CommonSEGD");
   CommonSEGD_py.def_readonly_static("GEN_HDR_SIZE", &CommonSEGD::GEN_HDR_SIZE);
@@ -1215,6 +1580,21 @@ PYBIND11_MODULE(pysedaman, m) {
     return s.has_record() ? s.read_trace() : throw py::stop_iteration();
   });
   ISEGD_py.def("__iter__", [](ISEGD &s) { return &s; });
+  ISEGD_py.def("read_record", &ISEGD::read_record,
+               "Returns all traces of current record");
+  py::class_<ISEGD::Record> Record_py(ISEGD_py, "Record");
+  Record_py.def_readonly("channel_sets", &ISEGD::Record::channel_sets);
+  Record_py.def_readonly("headers", &ISEGD::Record::headers);
+  py::class_<ISEGD::Record::ChannelSet> RecordChannelSet_py(Record_py,
+                                                            "ChannelSet");
+  RecordChannelSet_py.def_readonly("header",
+                                   &ISEGD::Record::ChannelSet::header);
+  RecordChannelSet_py.def_readonly("samp_num",
+                                   &ISEGD::Record::ChannelSet::samp_num);
+  RecordChannelSet_py.def_readonly("samples",
+                                   &ISEGD::Record::ChannelSet::samples);
+  RecordChannelSet_py.def_readonly("traces",
+                                   &ISEGD::Record::ChannelSet::traces);
 
   py::class_<OSEGD> OSEGD_py(m, "OSEGD");
   OSEGD_py.def("write_trace", &OSEGD::write_trace);
@@ -1227,5 +1607,40 @@ PYBIND11_MODULE(pysedaman, m) {
       py::arg("file_name"), py::arg("gh"), py::arg("gh2"), py::arg("ch_sets"),
       py::arg("add_ghs") =
           vector<shared_ptr<CommonSEGD::AdditionalGeneralHeader>>());
+
+  py::class_<Catalog> Catalog_py(m, "Catalog");
+  py::enum_<Catalog::Format>(Catalog_py, "Format")
+      .value("SEGY", Catalog::Format::SEGY)
+      .value("SEGD", Catalog::Format::SEGD);
+  py::class_<Catalog::Entry> Entry_py(Catalog_py, "Entry");
+  Entry_py.def_readonly("file_name", &Catalog::Entry::file_name);
+  Entry_py.def_readonly("format", &Catalog::Entry::format);
+  Entry_py.def_readonly("file_size", &Catalog::Entry::file_size);
+  Entry_py.def_readonly("binary_header", &Catalog::Entry::binary_header);
+  Entry_py.def_readonly("general_header", &Catalog::Entry::general_header);
+  Entry_py.def_readonly("samples_per_trace",
+                        &Catalog::Entry::samples_per_trace);
+  Entry_py.def_readonly("traces_count", &Catalog::Entry::traces_count);
+  Entry_py.def_readonly("error", &Catalog::Entry::error);
+  Catalog_py.def_static("probe_segy", &Catalog::probe_segy,
+                        "reads SEGY text and binary headers only",
+                        py::arg("file_name"));
+  Catalog_py.def_static("probe_segd", &Catalog::probe_segd,
+                        "reads SEGD headers before first trace",
+                        py::arg("file_name"));
+  Catalog_py.def_static("scan", &Catalog::scan,
+                        "probes all SEGY and SEGD files in directory tree",
+                        py::arg("dir_name"), py::arg("threads") = 0);
+
+  py::class_<ZStreambuf> ZStreambuf_py(m, "ZStreambuf");
+  ZStreambuf_py.def_static("is_compressed", &ZStreambuf::is_compressed,
+                           "checks gzip magic", py::arg("file_name"));
+  ZStreambuf_py.def_static("index_name", &ZStreambuf::index_name,
+                           "name of index file for compressed file",
+                           py::arg("file_name"));
+  ZStreambuf_py.def_static("write_index", &ZStreambuf::write_index,
+                           "saves seek points of compressed file to index",
+                           py::arg("file_name"),
+                           py::arg("span") = ZStreambuf::DEFAULT_SPAN);
 }
 } // namespace sedaman
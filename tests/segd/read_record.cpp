@@ -0,0 +1,59 @@
+#include "ISEGD.hpp"
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+        return 1;
+    try {
+        sedaman::ISEGD by_trace(argv[1]);
+        sedaman::ISEGD by_record(argv[1]);
+        while (by_record.has_record()) {
+            sedaman::ISEGD::Record rec = by_record.read_record();
+            uint64_t num = 0;
+            for (auto& set : rec.channel_sets)
+                num += set.traces.size();
+            for (auto& p : rec.headers)
+                if (p.second.size() != num) {
+                    std::cerr << "wrong size of " << p.first << " column\n";
+                    return 1;
+                }
+            std::vector<sedaman::Trace> traces;
+            for (uint64_t i = 0; i < num; ++i)
+                traces.push_back(by_trace.read_trace());
+            for (auto& set : rec.channel_sets)
+                for (size_t row = 0; row < set.traces.size(); ++row) {
+                    sedaman::Trace& trc = traces[set.traces[row]];
+                    if (trc.samples().size() != set.samp_num) {
+                        std::cerr << "wrong number of samples\n";
+                        return 1;
+                    }
+                    for (uint32_t i = 0; i < set.samp_num; ++i)
+                        if (trc.samples()[i] !=
+                            set.samples[row * set.samp_num + i]) {
+                            std::cerr << "samples differ\n";
+                            return 1;
+                        }
+                    bool same = true;
+                    trc.header().for_each([&](std::string const& key,
+                                              sedaman::Trace::Header::Value
+                                                  const& v) {
+                        if (rec.headers[key][set.traces[row]] != v) {
+                            std::cerr << key << " values differ\n";
+                            same = false;
+                        }
+                    });
+                    if (!same)
+                        return 1;
+                }
+        }
+        if (by_trace.has_record()) {
+            std::cerr << "not all records are read\n";
+            return 1;
+        }
+    } catch (std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
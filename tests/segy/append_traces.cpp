@@ -0,0 +1,115 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+template <typename W>
+static void write(W &out, std::vector<sedaman::Trace> &traces, size_t from,
+                  size_t to)
+{
+    for (size_t i = from; i < to; ++i)
+        out.write_trace(traces[i]);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        sedaman::ISEGY in(argv[1]);
+        std::vector<sedaman::Trace> traces;
+        while (in.has_trace())
+            traces.push_back(in.read_trace());
+        size_t const num = traces.size();
+        // part of sample file with the rest appended gives sample file back
+        {
+            sedaman::OSEGYRev1 part(prefix + "app1.sgy", in.text_headers(),
+                                    in.binary_header());
+            write(part, traces, 0, num / 3);
+        }
+        {
+            sedaman::OSEGYRev1 app(prefix + "app1.sgy",
+                                   sedaman::OSEGYRev1::Append());
+            write(app, traces, num / 3, num);
+        }
+        if (content(argv[1]) != content(prefix + "app1.sgy"))
+        {
+            std::cerr << "appended rev1 file differs from sample\n";
+            return 1;
+        }
+        // trailer stanza is moved after new traces, number of traces grows
+        sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+        bh.SEGY_rev_major_ver = 2;
+        bh.max_num_add_tr_headers = 1;
+        bh.num_of_trailer_stanza = 1;
+        std::vector<std::string> stanzas = {
+            std::string(sedaman::CommonSEGY::TEXT_HEADER_SIZE, 'S')};
+        bh.num_of_tr_in_file = num;
+        {
+            sedaman::OSEGYRev2 ref(prefix + "ref2.sgy", in.text_headers(), bh,
+                                   stanzas);
+            write(ref, traces, 0, num);
+        }
+        bh.num_of_tr_in_file = num / 3;
+        {
+            sedaman::OSEGYRev2 part(prefix + "app2.sgy", in.text_headers(),
+                                    bh, stanzas);
+            write(part, traces, 0, num / 3);
+        }
+        {
+            // new data is shorter than trailer stanza
+            sedaman::OSEGYRev2 app(prefix + "app2.sgy",
+                                   sedaman::OSEGYRev2::Append());
+            write(app, traces, num / 3, num / 3 + 1);
+        }
+        {
+            sedaman::OSEGYRev2 app(prefix + "app2.sgy",
+                                   sedaman::OSEGYRev2::Append());
+            std::vector<sedaman::Trace> batch(traces.begin() + num / 3 + 1,
+                                              traces.end());
+            app.write_traces(batch);
+        }
+        if (content(prefix + "ref2.sgy") != content(prefix + "app2.sgy"))
+        {
+            std::cerr << "appended rev2 file differs\n";
+            return 1;
+        }
+        sedaman::ISEGY app2(prefix + "app2.sgy");
+        if (app2.traces_count() != num ||
+            app2.trailer_stanzas() != stanzas)
+        {
+            std::cerr << "wrong appended rev2 file\n";
+            return 1;
+        }
+        try
+        {
+            sedaman::OSEGYRev1 app(prefix + "app2.sgy",
+                                   sedaman::OSEGYRev1::Append());
+            std::cerr << "revision 2 file is opened by OSEGYRev1\n";
+            return 1;
+        }
+        catch (sedaman::Exception &)
+        {
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "AsyncWriter.hpp"
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// trace with more samples than fixed length file allows
+static sedaman::Trace wrong_trace()
+{
+    return sedaman::Trace({{"SAMP_NUM", 40000}, {"SAMP_INT", 2000}},
+                          std::vector<double>(40000));
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        sedaman::ISEGY in(argv[1]);
+        std::string ref = content(argv[1]);
+        uint64_t num = in.traces_count();
+        size_t trc_size = (ref.size() - 3600) / num;
+        sedaman::AsyncWriter async(
+            std::make_unique<sedaman::OSEGYRev1>(
+                prefix + "async.sgy", in.text_headers(), in.binary_header()),
+            16);
+        for (uint64_t i = 0; in.has_trace(); ++i)
+        {
+            async.write_trace(in.read_trace());
+            if (i == num / 2)
+            {
+                // flushed traces are in file while writer is open
+                async.flush();
+                if (content(prefix + "async.sgy") !=
+                    ref.substr(0, 3600 + (i + 1) * trc_size))
+                {
+                    std::cerr << "flushed traces are not in file\n";
+                    return 1;
+                }
+            }
+        }
+        async.close();
+        if (ref != content(prefix + "async.sgy"))
+        {
+            std::cerr << "async output differs from original file\n";
+            return 1;
+        }
+        in.seek_trace(0);
+        sedaman::Trace first = in.read_trace();
+        // error of background thread is reported to caller
+        sedaman::AsyncWriter bad(
+            std::make_unique<sedaman::OSEGYRev1>(
+                prefix + "bad.sgy", in.text_headers(), in.binary_header()),
+            4);
+        bad.write_trace(wrong_trace());
+        try
+        {
+            bad.flush();
+            std::cerr << "error is not reported\n";
+            return 1;
+        }
+        catch (sedaman::Exception &)
+        {
+        }
+        // error is kept, nothing more goes to broken file
+        for (int i = 0; i < 3; ++i)
+        {
+            try
+            {
+                if (i == 0)
+                    bad.write_trace(first);
+                else if (i == 1)
+                    bad.flush();
+                else
+                    bad.close();
+                std::cerr << "error is reported only once\n";
+                return 1;
+            }
+            catch (sedaman::Exception &)
+            {
+            }
+        }
+        try
+        {
+            bad.write_trace(first);
+            std::cerr << "write after close is not detected\n";
+            return 1;
+        }
+        catch (sedaman::Exception &)
+        {
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
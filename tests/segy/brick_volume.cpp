@@ -0,0 +1,135 @@
+#include "BrickVolume.hpp"
+#include "ISEGY3D.hpp"
+#include "OSEGYRev1.hpp"
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+        return 1;
+    int const samp_num = 50;
+    std::string segy_name = std::string(argv[1]) + ".sgy";
+    std::string brk_name = std::string(argv[1]) + ".brk";
+    std::string copy_name = std::string(argv[1]) + "_copy.sgy";
+    try
+    {
+        sedaman::CommonSEGY::BinaryHeader bh = {};
+        bh.format_code = 5;
+        bh.samp_int = 2000;
+        bh.samp_per_tr = samp_num;
+        bh.fixed_tr_length = 1;
+        bh.SEGY_rev_major_ver = 1;
+        {
+            sedaman::OSEGYRev1 out(segy_name, {}, bh);
+            for (int64_t il = 10; il <= 18; il += 2)
+                for (int64_t xl = 1; xl <= 7; ++xl)
+                {
+                    if (il == 14 && xl == 3)
+                        continue;
+                    std::vector<double> samples(samp_num);
+                    for (int s = 0; s < samp_num; ++s)
+                        samples[s] = il * 1000 + xl * 10 + s * 0.25;
+                    sedaman::Trace t({{"INLINE", il}, {"XLINE", xl},
+                                      {"CDP_X", il * 25}, {"CDP_Y", xl * 25},
+                                      {"SAMP_NUM", samp_num},
+                                      {"SAMP_INT", 2000}},
+                                     samples);
+                    out.write_trace(t);
+                }
+        }
+        {
+            // unassigned bytes 233-240 are out of trace header map
+            std::fstream fl(segy_name,
+                            std::ios::binary | std::ios::in | std::ios::out);
+            for (int n = 0; n < 34; ++n)
+            {
+                fl.seekp(3600 + n * (240 + samp_num * 4) + 232);
+                fl.write("UNMAPPED", 8);
+            }
+        }
+        // brick sizes are not multiples of volume size to check padding
+        sedaman::BrickVolume::from_segy(segy_name, brk_name, 2, 3, 16, 6,
+                                        "INLINE", "XLINE", 2);
+        sedaman::ISEGY3D ref(segy_name);
+        sedaman::BrickVolume vol(brk_name);
+        if (vol.grid().il_first != 10 || vol.grid().il_step != 2 ||
+            vol.grid().il_num != 5 || vol.grid().xl_num != 7 ||
+            vol.grid().missing != 1 || vol.samples_per_trace() != samp_num)
+        {
+            std::cerr << "wrong grid\n";
+            return 1;
+        }
+        if (vol.binary_header().format_code != 5 ||
+            vol.binary_header().samp_int != 2000 ||
+            vol.binary_header().samp_per_tr != samp_num ||
+            vol.binary_header().SEGY_rev_major_ver != 1)
+        {
+            std::cerr << "wrong binary header\n";
+            return 1;
+        }
+        for (int64_t il = 10; il <= 18; il += 2)
+            if (vol.inline_section(il) != ref.inline_section(il))
+            {
+                std::cerr << "wrong inline " << il << '\n';
+                return 1;
+            }
+        for (int64_t xl = 1; xl <= 7; ++xl)
+            if (vol.crossline_section(xl) != ref.crossline_section(xl))
+            {
+                std::cerr << "wrong crossline " << xl << '\n';
+                return 1;
+            }
+        for (uint32_t s = 0; s < samp_num; s += 7)
+            if (vol.time_slice(s) != ref.time_slice(s))
+            {
+                std::cerr << "wrong time slice " << s << '\n';
+                return 1;
+            }
+        // traces are in inline, crossline order, so copy is the same file
+        vol.to_segy(copy_name);
+        std::ifstream orig(segy_name, std::ios::binary);
+        std::ifstream copy(copy_name, std::ios::binary);
+        if (!std::equal(std::istreambuf_iterator<char>(orig),
+                        std::istreambuf_iterator<char>(),
+                        std::istreambuf_iterator<char>(copy),
+                        std::istreambuf_iterator<char>()))
+        {
+            std::cerr << "converted file differs from original\n";
+            return 1;
+        }
+        // the same bricks are made from compressed input
+        std::string gz_name = segy_name + ".gz";
+        std::string gz_brk_name = std::string(argv[1]) + "_gz.brk";
+        std::ifstream in(segy_name, std::ios::binary);
+        std::vector<char> data((std::istreambuf_iterator<char>(in)),
+                               std::istreambuf_iterator<char>());
+        gzFile gz = gzopen(gz_name.c_str(), "wb6");
+        gzwrite(gz, data.data(), data.size());
+        gzclose(gz);
+        sedaman::BrickVolume::from_segy(gz_name, gz_brk_name, 2, 3, 16, 6,
+                                        "INLINE", "XLINE", 2);
+        std::ifstream a(brk_name, std::ios::binary);
+        std::ifstream b(gz_brk_name, std::ios::binary);
+        if (!std::equal(std::istreambuf_iterator<char>(a),
+                        std::istreambuf_iterator<char>(),
+                        std::istreambuf_iterator<char>(b),
+                        std::istreambuf_iterator<char>()))
+        {
+            std::cerr << "bricks of compressed file differ\n";
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
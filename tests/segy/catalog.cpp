@@ -0,0 +1,80 @@
+#include "Catalog.hpp"
+#include "ISEGY.hpp"
+#include "ZStreambuf.hpp"
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <zlib.h>
+
+// gzip copy of file
+static void pack(std::string const &from, std::string const &to)
+{
+    std::ifstream in(from, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+    gzFile gz = gzopen(to.c_str(), "wb");
+    gzwrite(gz, data.data(), data.size());
+    gzclose(gz);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    namespace fs = std::filesystem;
+    try
+    {
+        // copy of samples with broken file in subdirectory
+        fs::remove_all(argv[2]);
+        fs::create_directories(fs::path(argv[2]) / "sub");
+        uint64_t good = 0;
+        for (auto const &de : fs::directory_iterator(argv[1]))
+            if (de.path().extension() == ".sgy")
+            {
+                fs::copy_file(de.path(),
+                              fs::path(argv[2]) / "sub" / de.path().filename());
+                ++good;
+            }
+        // compressed files with plain and archive names
+        fs::path ieee = fs::path(argv[1]) / "ieee_single.sgy";
+        pack(ieee, fs::path(argv[2]) / "packed.sgy");
+        pack(ieee, fs::path(argv[2]) / "packed.SEGY.gz");
+        std::ofstream(fs::path(argv[2]) / "broken.SGY") << "not a segy";
+        std::ofstream(fs::path(argv[2]) / "notes.gz") << "skipped";
+        std::ofstream(fs::path(argv[2]) / "notes.txt") << "skipped";
+        std::vector<sedaman::Catalog::Entry> cat =
+            sedaman::Catalog::scan(argv[2], 3);
+        if (cat.size() != good + 3 || cat.front().error.empty())
+        {
+            std::cerr << "wrong catalog\n";
+            return 1;
+        }
+        for (uint64_t i = 1; i < cat.size(); ++i)
+        {
+            sedaman::ISEGY segy(cat[i].file_name);
+            // trace count of compressed file is not derived from its size
+            bool packed =
+                sedaman::ZStreambuf::is_compressed(cat[i].file_name);
+            if (!cat[i].error.empty() ||
+                (packed ? cat[i].traces_count.has_value()
+                        : !cat[i].traces_count ||
+                              *cat[i].traces_count != segy.traces_count()) ||
+                cat[i].binary_header->format_code !=
+                    segy.binary_header().format_code ||
+                cat[i].file_size != fs::file_size(cat[i].file_name))
+            {
+                std::cerr << "wrong entry for " << cat[i].file_name << '\n';
+                return 1;
+            }
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
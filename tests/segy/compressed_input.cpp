@@ -0,0 +1,167 @@
+#include "ISEGYSorted1D.hpp"
+#include "OSEGYRev1.hpp"
+#include "ZStreambuf.hpp"
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+static bool same(sedaman::Trace &a, sedaman::Trace &b)
+{
+    return std::get<int64_t>(*a.header().get("TRC_SEQ_SGY")) ==
+               std::get<int64_t>(*b.header().get("TRC_SEQ_SGY")) &&
+           a.samples() == b.samples();
+}
+
+static bool compare(std::string const &plain_name, std::string const &z_name)
+{
+    sedaman::ISEGY plain(plain_name);
+    sedaman::ISEGY z(z_name);
+    if (z.traces_count() != plain.traces_count() ||
+        z.text_headers() != plain.text_headers())
+        return false;
+    while (plain.has_trace())
+    {
+        sedaman::Trace a = plain.read_trace();
+        sedaman::Trace b = z.read_trace();
+        if (!z.has_trace() == plain.has_trace() || !same(a, b))
+            return false;
+    }
+    // backward jumps go to seek points
+    for (uint64_t i = plain.traces_count(); i; i -= 7)
+    {
+        plain.seek_trace(i - 1);
+        z.seek_trace(i - 1);
+        sedaman::Trace a = plain.read_trace();
+        sedaman::Trace b = z.read_trace();
+        if (!same(a, b))
+            return false;
+        if (i < 7)
+            break;
+    }
+    std::vector<char> hdrs(plain.traces_count() * plain.raw_headers_size());
+    bool ok = true;
+    plain.read_raw_headers(
+        [&](unsigned, uint64_t n, char const *buf) {
+            std::copy(buf, buf + plain.raw_headers_size(),
+                      hdrs.begin() + n * plain.raw_headers_size());
+        },
+        2);
+    // every thread decompresses from its own seek point
+    z.read_raw_headers(
+        [&](unsigned, uint64_t n, char const *buf) {
+            ok = ok && std::equal(buf, buf + plain.raw_headers_size(),
+                                  hdrs.begin() + n * plain.raw_headers_size());
+        },
+        2);
+    sedaman::ISEGYSorted1D plain_sorted(plain_name, "FFID");
+    sedaman::ISEGYSorted1D z_sorted(z_name, "FFID");
+    while (ok && plain_sorted.has_trace())
+    {
+        sedaman::Trace a = plain_sorted.read_trace();
+        sedaman::Trace b = z_sorted.read_trace();
+        ok = same(a, b);
+    }
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string name = std::string(argv[1]) + ".sgy";
+    std::string gz_name = name + ".gz";
+    std::string zz_name = name + ".zz";
+    try
+    {
+        sedaman::CommonSEGY::BinaryHeader bh = {};
+        bh.format_code = 5;
+        bh.samp_int = 2000;
+        bh.samp_per_tr = 500;
+        bh.fixed_tr_length = 1;
+        bh.SEGY_rev_major_ver = 1;
+        {
+            // noise makes many deflate blocks and seek points
+            uint32_t seed = 1;
+            sedaman::OSEGYRev1 out(name, {}, bh);
+            for (int i = 0; i < 500; ++i)
+            {
+                std::vector<double> smpls(500);
+                for (double &v : smpls)
+                {
+                    seed = seed * 1664525 + 1013904223;
+                    v = static_cast<int>(seed >> 20);
+                }
+                sedaman::Trace t({{"TRC_SEQ_SGY", i}, {"FFID", i % 7},
+                                  {"SAMP_NUM", 500}, {"SAMP_INT", 2000}},
+                                 smpls);
+                out.write_trace(t);
+            }
+        }
+        std::ifstream in(name, std::ios::binary);
+        std::vector<char> data((std::istreambuf_iterator<char>(in)),
+                               std::istreambuf_iterator<char>());
+        // two gzip members, as written by parallel compressors
+        std::filesystem::remove(gz_name);
+        std::filesystem::remove(sedaman::ZStreambuf::index_name(gz_name));
+        size_t half = data.size() / 2 + 13;
+        for (auto [from, to] : {std::pair<size_t, size_t>(0, half),
+                                std::pair<size_t, size_t>(half, data.size())})
+        {
+            gzFile gz = gzopen(gz_name.c_str(), "ab6");
+            gzwrite(gz, data.data() + from, to - from);
+            gzclose(gz);
+        }
+        uLongf zz_size = compressBound(data.size());
+        std::vector<char> zz(zz_size);
+        compress2(reinterpret_cast<Bytef *>(zz.data()), &zz_size,
+                  reinterpret_cast<Bytef const *>(data.data()), data.size(),
+                  9);
+        std::ofstream(zz_name, std::ios::binary).write(zz.data(), zz_size);
+        // zlib stream is not detected, but is read by ZStreambuf directly
+        sedaman::ZStreambuf zz_buf(zz_name);
+        std::istream zz_in(&zz_buf);
+        if (!sedaman::ZStreambuf::is_compressed(gz_name) ||
+            sedaman::ZStreambuf::is_compressed(zz_name) ||
+            sedaman::ZStreambuf::is_compressed(name) ||
+            std::vector<char>((std::istreambuf_iterator<char>(zz_in)),
+                              std::istreambuf_iterator<char>()) != data)
+        {
+            std::cerr << "wrong compression detection\n";
+            return 1;
+        }
+        if (!compare(name, gz_name))
+        {
+            std::cerr << "compressed file differs from plain\n";
+            return 1;
+        }
+        // plain text header starting with valid zlib header bytes
+        std::string hk_name = std::string(argv[1]) + "_hk.sgy";
+        std::filesystem::copy_file(
+            argv[2], hk_name, std::filesystem::copy_options::overwrite_existing);
+        std::fstream(hk_name, std::ios::binary | std::ios::in | std::ios::out)
+            .write("HK", 2);
+        if (sedaman::ZStreambuf::is_compressed(hk_name) ||
+            sedaman::ISEGY(hk_name).traces_count() != 160)
+        {
+            std::cerr << "plain file is taken for compressed\n";
+            return 1;
+        }
+        sedaman::ZStreambuf::write_index(gz_name, 32768);
+        if (!compare(name, gz_name))
+        {
+            std::cerr << "compressed file with index differs from plain\n";
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
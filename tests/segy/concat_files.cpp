@@ -0,0 +1,170 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include "SEGYMerger.hpp"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// pieces of sample, one of them without traces
+static std::vector<size_t> const bounds = {0, 13, 13, 40, 71, 160};
+
+// writes traces with sequence numbers spoiled, so renumbering is visible;
+// traces of variable length file are shortened a bit
+static void write_file(std::string const &name, sedaman::ISEGY &in,
+                       std::vector<sedaman::Trace> &traces,
+                       size_t from, size_t to, bool fixed)
+{
+    sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+    std::unique_ptr<sedaman::OSEGY> out;
+    if (fixed)
+    {
+        bh.SEGY_rev_major_ver = 2;
+        out = std::make_unique<sedaman::OSEGYRev2>(name, in.text_headers(),
+                                                   bh);
+    }
+    else
+    {
+        bh.fixed_tr_length = 0;
+        out = std::make_unique<sedaman::OSEGYRev1>(name, in.text_headers(),
+                                                   bh);
+    }
+    for (size_t i = from; i < to; ++i)
+    {
+        std::vector<double> smpls = traces[i].samples();
+        if (!fixed)
+            smpls.resize(smpls.size() - i % 7);
+        sedaman::Trace::Header hdr = traces[i].header();
+        hdr.set("SAMP_NUM", static_cast<int64_t>(smpls.size()));
+        hdr.set("TRC_SEQ_LINE", 7);
+        hdr.set("TRC_SEQ_SGY", 7);
+        sedaman::Trace t(hdr, smpls);
+        out->write_trace(t);
+    }
+}
+
+static bool check(std::string const &prefix, sedaman::ISEGY &in,
+                  std::vector<sedaman::Trace> &traces, bool fixed,
+                  bool renumber)
+{
+    std::string name = prefix + (renumber ? "_ren.sgy" : "_raw.sgy");
+    {
+        sedaman::SEGYMerger merger(
+            name, renumber ? std::vector<std::string>{"TRC_SEQ_LINE",
+                                                      "TRC_SEQ_SGY"}
+                           : std::vector<std::string>{});
+        for (size_t f = 0; f + 1 < bounds.size(); ++f)
+        {
+            std::string part = prefix + "_" + std::to_string(f) + ".sgy";
+            write_file(part, in, traces, bounds[f], bounds[f + 1], fixed);
+            merger.add(part);
+        }
+        if (merger.traces_count() != traces.size())
+        {
+            std::cerr << name << " wrong number of merged traces\n";
+            return false;
+        }
+    }
+    sedaman::ISEGY out(name);
+    if (out.traces_count() != traces.size() ||
+        (fixed && out.binary_header().num_of_tr_in_file != traces.size()))
+    {
+        std::cerr << name << " wrong number of traces\n";
+        return false;
+    }
+    for (size_t i = 0; i < traces.size(); ++i)
+    {
+        sedaman::Trace t = out.read_trace();
+        std::vector<double> smpls = traces[i].samples();
+        if (!fixed)
+            smpls.resize(smpls.size() - i % 7);
+        int64_t seq = renumber ? i + 1 : 7;
+        if (t.samples() != smpls ||
+            *t.header().get("CHAN") != *traces[i].header().get("CHAN") ||
+            std::get<int64_t>(*t.header().get("TRC_SEQ_LINE")) != seq ||
+            std::get<int64_t>(*t.header().get("TRC_SEQ_SGY")) != seq)
+        {
+            std::cerr << name << " wrong trace " << i << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        sedaman::ISEGY in(argv[1]);
+        std::vector<sedaman::Trace> traces;
+        while (in.has_trace())
+            traces.push_back(in.read_trace());
+        // pieces of sample are merged back into it
+        {
+            sedaman::SEGYMerger merger(prefix + "sample.sgy");
+            for (size_t f = 0; f + 1 < bounds.size(); ++f)
+            {
+                std::vector<uint64_t> nums;
+                for (size_t i = bounds[f]; i < bounds[f + 1]; ++i)
+                    nums.push_back(i);
+                std::string part = prefix + "piece" + std::to_string(f) +
+                                   ".sgy";
+                in.extract_traces(part, nums);
+                merger.add(part);
+            }
+        }
+        if (content(argv[1]) != content(prefix + "sample.sgy"))
+        {
+            std::cerr << "merged pieces differ from sample\n";
+            return 1;
+        }
+        if (!check(prefix + "var", in, traces, false, false) ||
+            !check(prefix + "var", in, traces, false, true) ||
+            !check(prefix + "fix", in, traces, true, false) ||
+            !check(prefix + "fix", in, traces, true, true))
+            return 1;
+        // other trace length is refused
+        {
+            sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+            bh.SEGY_rev_major_ver = 2;
+            bh.samp_per_tr = 30;
+            sedaman::OSEGYRev2 out(prefix + "other.sgy", in.text_headers(),
+                                   bh);
+            sedaman::Trace::Header hdr = traces[0].header();
+            hdr.set("SAMP_NUM", 30);
+            sedaman::Trace t(hdr, std::vector<double>(30, 1));
+            out.write_trace(t);
+        }
+        sedaman::SEGYMerger merger(prefix + "bad.sgy");
+        merger.add(prefix + "fix_0.sgy");
+        try
+        {
+            merger.add(prefix + "other.sgy");
+        }
+        catch (sedaman::Exception &)
+        {
+            return 0;
+        }
+        std::cerr << "different trace length is accepted\n";
+        return 1;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,112 @@
+#include "ISEGYDataset.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+        return 1;
+    int const counts[] = {5, 7, 1, 3, 4};
+    try
+    {
+        sedaman::CommonSEGY::BinaryHeader bh = {};
+        bh.format_code = 5;
+        bh.samp_int = 2000;
+        bh.samp_per_tr = 4;
+        bh.fixed_tr_length = 1;
+        bh.SEGY_rev_major_ver = 1;
+        std::vector<std::string> names;
+        int64_t total = 0;
+        for (int f = 0; f < 4; ++f)
+        {
+            names.push_back(std::string(argv[1]) + std::to_string(f) + ".sgy");
+            sedaman::OSEGYRev1 out(names.back(), {}, bh);
+            for (int i = 0; i < counts[f]; ++i, ++total)
+            {
+                sedaman::Trace t({{"TRC_SEQ_SGY", total}, {"FFID", f},
+                                  {"SAMP_NUM", 4}, {"SAMP_INT", 2000}},
+                                 std::vector<double>(4, total));
+                out.write_trace(t);
+            }
+        }
+        // variable trace length, traces are indexed on construction
+        bh.SEGY_rev_major_ver = 2;
+        bh.fixed_tr_length = 0;
+        names.push_back(std::string(argv[1]) + "4.sgy");
+        {
+            sedaman::OSEGYRev2 out(names.back(), {}, bh, {});
+            for (int i = 0; i < counts[4]; ++i, ++total)
+            {
+                sedaman::Trace t({{"TRC_SEQ_SGY", total}, {"FFID", 4},
+                                  {"SAMP_NUM", 4 + i}, {"SAMP_INT", 2000}},
+                                 std::vector<double>(4 + i, total));
+                out.write_trace(t);
+            }
+        }
+        sedaman::ISEGYDataset ds(names,
+                                 sedaman::CommonSEGY::default_trace_header, 2);
+        // headers are not read again, so broken byte order goes unnoticed
+        for (std::string const &name : names)
+            std::fstream(name, std::ios::binary | std::ios::in | std::ios::out)
+                .seekp(3296)
+                .write("\x11\x22\x33\x44", 4);
+        if (ds.files_count() != 5 ||
+            ds.traces_count() != static_cast<uint64_t>(total) ||
+            ds.locate(12) != std::pair<uint64_t, uint64_t>(2, 0))
+        {
+            std::cerr << "wrong dataset size\n";
+            return 1;
+        }
+        int64_t n = 0;
+        for (; ds.has_trace(); ++n)
+        {
+            sedaman::Trace t = ds.read_trace();
+            if (std::get<int64_t>(*t.header().get("TRC_SEQ_SGY")) != n ||
+                t.samples()[3] != n)
+            {
+                std::cerr << "wrong trace " << n << '\n';
+                return 1;
+            }
+        }
+        ds.seek_trace(13);
+        if (n != total ||
+            std::get<int64_t>(*ds.read_header().get("FFID")) != 3)
+        {
+            std::cerr << "wrong seek\n";
+            return 1;
+        }
+        // going back and forth between files keeps position of each one
+        for (int64_t i : {0, 5, 1, 6, 2, 12, 3, 7, 17, 13, 8, 19, 16})
+        {
+            ds.seek_trace(i);
+            if (std::get<int64_t>(*ds.read_header().get("TRC_SEQ_SGY")) != i)
+            {
+                std::cerr << "wrong trace " << i << " after switch\n";
+                return 1;
+            }
+        }
+        std::vector<sedaman::Trace::Header::Value> vals =
+            ds.header_values("TRC_SEQ_SGY", 3);
+        for (int64_t i = 0; i < total; ++i)
+            if (std::get<int64_t>(vals[i]) != i)
+            {
+                std::cerr << "wrong header values\n";
+                return 1;
+            }
+        if (ds.header_values("TRC_SEQ_SGY") != vals)
+        {
+            std::cerr << "wrong kept header values\n";
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
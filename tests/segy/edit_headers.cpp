@@ -0,0 +1,146 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "SEGYEditor.hpp"
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+static int64_t cdp_x(uint64_t n) { return n == 3 ? -15 : n * 10 + 5; }
+
+static bool edit(std::string const &name, uint64_t num, bool fixed)
+{
+    sedaman::SEGYEditor ed(name);
+    if (ed.traces_count() != num)
+    {
+        std::cerr << "wrong number of traces\n";
+        return false;
+    }
+    ed.edit_headers([](uint64_t n, sedaman::Trace::Header &hdr) {
+        hdr.set("CDP_X", static_cast<int64_t>(n * 10 + 5));
+    });
+    sedaman::Trace::Header hdr = ed.read_header(3);
+    hdr.set("CDP_X", cdp_x(3));
+    ed.write_header(3, hdr);
+    sedaman::CommonSEGY::BinaryHeader bh = ed.binary_header();
+    bh.job_id = 42;
+    ed.write_binary_header(bh);
+    try
+    {
+        bh.format_code = bh.format_code == 1 ? 5 : 1;
+        ed.write_binary_header(bh);
+        std::cerr << "layout change is not detected\n";
+        return false;
+    }
+    catch (sedaman::Exception &)
+    {
+    }
+    if (!fixed)
+        try
+        {
+            sedaman::Trace::Header h({{"SAMP_NUM", 10}});
+            ed.write_header(0, h);
+            std::cerr << "samples number change is not detected\n";
+            return false;
+        }
+        catch (sedaman::Exception &)
+        {
+        }
+    return true;
+}
+
+// only edited values differ from original
+static bool check(std::string const &orig, std::string const &name)
+{
+    sedaman::ISEGY ref(orig);
+    sedaman::ISEGY in(name);
+    if (in.binary_header().job_id != 42)
+    {
+        std::cerr << name << " binary header is not written\n";
+        return false;
+    }
+    for (uint64_t n = 0; ref.has_trace(); ++n)
+    {
+        sedaman::Trace a = ref.read_trace();
+        sedaman::Trace b = in.read_trace();
+        if (a.samples() != b.samples() ||
+            std::get<int64_t>(*b.header().get("CDP_X")) != cdp_x(n))
+        {
+            std::cerr << name << " wrong trace " << n << '\n';
+            return false;
+        }
+        for (auto &k : a.header().keys())
+            if (k != "CDP_X" && *a.header().get(k) != *b.header().get(k))
+            {
+                std::cerr << name << " " << k << " is changed in trace " << n
+                          << '\n';
+                return false;
+            }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        // fixed length sample is edited in place
+        std::string fix_name = prefix + "fix.sgy";
+        std::filesystem::copy_file(
+            argv[1], fix_name,
+            std::filesystem::copy_options::overwrite_existing);
+        uint64_t num = sedaman::ISEGY(argv[1]).traces_count();
+        if (!edit(fix_name, num, true) || !check(argv[1], fix_name))
+            return 1;
+        // job id and CDP_X of every trace are the only changed bytes
+        std::string a = content(argv[1]), b = content(fix_name);
+        size_t trc_size = (a.size() - 3600) / num;
+        if (a.size() != b.size())
+        {
+            std::cerr << "file size is changed\n";
+            return 1;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+            if (a[i] != b[i] && !(i >= 3200 && i < 3204) &&
+                !(i >= 3600 && (i - 3600) % trc_size >= 180 &&
+                  (i - 3600) % trc_size < 184))
+            {
+                std::cerr << "byte " << i << " is changed\n";
+                return 1;
+            }
+        // the same traces with variable length
+        std::string var_name = prefix + "var.sgy";
+        {
+            sedaman::ISEGY in(argv[1]);
+            sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+            bh.fixed_tr_length = 0;
+            sedaman::OSEGYRev1 out(var_name, in.text_headers(), bh);
+            while (in.has_trace())
+            {
+                sedaman::Trace t = in.read_trace();
+                out.write_trace(t);
+            }
+        }
+        if (!edit(var_name, num, false) || !check(argv[1], var_name))
+            return 1;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// extracted traces are the same as given traces of source file
+static bool check(std::string const &src, std::string const &name,
+                  std::vector<uint64_t> const &nums)
+{
+    sedaman::ISEGY ref(src);
+    sedaman::ISEGY in(name);
+    if (ref.binary_header().SEGY_rev_major_ver > 1 &&
+        (in.binary_header().num_of_tr_in_file != nums.size() ||
+         in.trailer_stanzas() != ref.trailer_stanzas()))
+    {
+        std::cerr << name << " wrong binary header or trailer\n";
+        return false;
+    }
+    for (uint64_t n : nums)
+    {
+        ref.seek_trace(n);
+        sedaman::Trace a = ref.read_trace();
+        sedaman::Trace b = in.read_trace();
+        if (a.samples() != b.samples() ||
+            *a.header().get("TRC_SEQ_SGY") != *b.header().get("TRC_SEQ_SGY"))
+        {
+            std::cerr << name << " wrong trace " << n << '\n';
+            return false;
+        }
+    }
+    if (in.has_trace())
+    {
+        std::cerr << name << " too many traces\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        sedaman::ISEGY in(argv[1]);
+        std::vector<sedaman::Trace> traces;
+        while (in.has_trace())
+            traces.push_back(in.read_trace());
+        uint64_t const num = traces.size();
+        // all traces in order give sample file back
+        std::vector<uint64_t> all(num);
+        for (uint64_t i = 0; i < num; ++i)
+            all[i] = i;
+        in.extract_traces(prefix + "all.sgy", all);
+        if (content(argv[1]) != content(prefix + "all.sgy"))
+        {
+            std::cerr << "extracted traces differ from sample\n";
+            return 1;
+        }
+        // same traces in revision 2 file with trailer stanza and in file
+        // with variable trace length, every trace is shortened a bit
+        sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+        bh.SEGY_rev_major_ver = 2;
+        bh.num_of_tr_in_file = num;
+        bh.num_of_trailer_stanza = 1;
+        {
+            sedaman::OSEGYRev2 out(
+                prefix + "fix.sgy", in.text_headers(), bh,
+                {std::string(sedaman::CommonSEGY::TEXT_HEADER_SIZE, 'S')});
+            for (sedaman::Trace &t : traces)
+                out.write_trace(t);
+        }
+        bh = in.binary_header();
+        bh.fixed_tr_length = 0;
+        {
+            sedaman::OSEGYRev1 out(prefix + "var.sgy", in.text_headers(), bh);
+            for (uint64_t i = 0; i < num; ++i)
+            {
+                std::vector<double> smpls = traces[i].samples();
+                smpls.resize(smpls.size() - i % 5);
+                sedaman::Trace::Header hdr = traces[i].header();
+                hdr.set("SAMP_NUM", static_cast<int64_t>(smpls.size()));
+                sedaman::Trace t(hdr, smpls);
+                out.write_trace(t);
+            }
+        }
+        // ranges of consecutive traces, single ones and the last one
+        std::vector<uint64_t> const nums = {2,   3,   4,   5,  17,
+                                            0, 130, 131, num - 1};
+        std::string const names[] = {argv[1], prefix + "fix.sgy",
+                                     prefix + "var.sgy"};
+        for (int i = 0; i < 3; ++i)
+        {
+            std::string const &name = names[i];
+            std::string sub = prefix + std::to_string(i) + "_sub.sgy";
+            sedaman::ISEGY src(name);
+            src.read_trace();
+            src.extract_traces(sub, nums);
+            // position is kept
+            if (*src.read_header().get("TRC_SEQ_SGY") !=
+                *traces[1].header().get("TRC_SEQ_SGY"))
+            {
+                std::cerr << "position is changed\n";
+                return 1;
+            }
+            if (!check(name, sub, nums))
+                return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
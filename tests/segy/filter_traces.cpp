@@ -0,0 +1,79 @@
+#include "Exception.hpp"
+#include "ISEGYFiltered.hpp"
+#include <exception>
+#include <functional>
+#include <iostream>
+
+static int64_t value(sedaman::Trace::Header &h, char const *name)
+{
+    return std::get<int64_t>(*h.get(name));
+}
+
+static bool check(char const *file, char const *expr,
+                  std::function<bool(sedaman::Trace::Header &)> ref)
+{
+    sedaman::ISEGY all(file);
+    sedaman::ISEGYFiltered flt(file, expr);
+    uint64_t matched = 0;
+    while (all.has_trace())
+    {
+        sedaman::Trace t = all.read_trace();
+        if (!ref(t.header()))
+            continue;
+        ++matched;
+        if (!flt.has_trace())
+            return false;
+        sedaman::Trace f = flt.read_trace();
+        if (value(f.header(), "TRC_SEQ_SGY") !=
+                value(t.header(), "TRC_SEQ_SGY") ||
+            f.samples() != t.samples())
+            return false;
+    }
+    return !flt.has_trace() && flt.selected().size() == matched;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+        return 1;
+    try
+    {
+        if (!check(argv[1], "OFFSET > 1000 && CHAN % 2 == 0 && TRACE_ID == 1",
+                   [](sedaman::Trace::Header &h) {
+                       return value(h, "OFFSET") > 1000 &&
+                              value(h, "CHAN") % 2 == 0 &&
+                              value(h, "TRACE_ID") == 1;
+                   }) ||
+            !check(argv[1], "!(FFID == FFID) || -OFFSET >= -(100 + 2 * 25)",
+                   [](sedaman::Trace::Header &h) {
+                       return value(h, "OFFSET") <= 150;
+                   }) ||
+            !check(argv[1], "CHAN<=3||CHAN>=38",
+                   [](sedaman::Trace::Header &h) {
+                       return value(h, "CHAN") <= 3 || value(h, "CHAN") >= 38;
+                   }))
+        {
+            std::cerr << "wrong filtered traces\n";
+            return 1;
+        }
+        for (char const *bad : {"OFFSET >", "NO_SUCH_HEADER == 1",
+                                "(OFFSET > 1", "OFFSET 1"})
+        {
+            try
+            {
+                sedaman::ISEGYFiltered flt(argv[1], bad);
+                std::cerr << "no error for " << bad << '\n';
+                return 1;
+            }
+            catch (sedaman::Exception &)
+            {
+            }
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
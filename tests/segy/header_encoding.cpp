@@ -0,0 +1,96 @@
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include <exception>
+#include <iostream>
+#include <string>
+
+template <typename T>
+static bool check(sedaman::Trace::Header const &h, char const *name, T v)
+{
+    auto val = h.get(name);
+    return val && std::holds_alternative<T>(*val) && std::get<T>(*val) == v;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+        return 1;
+    std::string prefix = argv[1];
+    try
+    {
+        sedaman::CommonSEGY::BinaryHeader bh = {};
+        bh.format_code = 5;
+        bh.samp_int = 2000;
+        bh.samp_per_tr = 10;
+        bh.fixed_tr_length = 1;
+        bh.SEGY_rev_major_ver = 1;
+        // floating point values go to integer fields rounded
+        {
+            sedaman::OSEGYRev1 out(prefix + "rev1.sgy", {}, bh);
+            for (int i = 0; i < 3; ++i)
+            {
+                sedaman::Trace t({{"TRC_SEQ_SGY", i}, {"OFFSET", 123.6 + i},
+                                  {"SAMP_INT", 2000.0}, {"SAMP_NUM", 10}},
+                                 std::vector<double>(10, i));
+                out.write_trace(t);
+            }
+        }
+        sedaman::ISEGY rev1(prefix + "rev1.sgy");
+        for (int64_t i = 0; i < 3; ++i)
+        {
+            sedaman::Trace t = rev1.read_trace();
+            if (!check<int64_t>(t.header(), "TRC_SEQ_SGY", i) ||
+                !check<int64_t>(t.header(), "OFFSET", 124 + i) ||
+                !check<int64_t>(t.header(), "SAMP_INT", 2000))
+            {
+                std::cerr << "wrong rev1 header " << i << '\n';
+                return 1;
+            }
+        }
+        // all additional headers are written and read back
+        bh.SEGY_rev_major_ver = 2;
+        bh.max_num_add_tr_headers = 1;
+        {
+            sedaman::OSEGYRev2 out(prefix + "rev2.sgy", {}, bh);
+            for (int i = 0; i < 3; ++i)
+            {
+                sedaman::Trace t({{"TRC_SEQ_SGY", i}, {"OFFSET", 123.6 + i},
+                                  {"CDP_X", 1000 + i}, {"SAMP_INT", 2000},
+                                  {"SAMP_NUM", 10}},
+                                 std::vector<double>(10, i));
+                out.write_trace(t);
+            }
+        }
+        sedaman::ISEGY rev2(prefix + "rev2.sgy");
+        for (int64_t i = 0; i < 3; ++i)
+        {
+            if (!rev2.has_trace())
+            {
+                std::cerr << "missing rev2 trace " << i << '\n';
+                return 1;
+            }
+            sedaman::Trace t = rev2.read_trace();
+            if (!check<int64_t>(t.header(), "TRC_SEQ_SGY", i) ||
+                !check<double>(t.header(), "OFFSET", 123.6 + i) ||
+                !check<double>(t.header(), "CDP_X", 1000.0 + i) ||
+                !check<int64_t>(t.header(), "SAMP_NUM", 10) ||
+                t.samples() != std::vector<double>(10, i))
+            {
+                std::cerr << "wrong rev2 trace " << i << '\n';
+                return 1;
+            }
+        }
+        if (rev2.has_trace())
+        {
+            std::cerr << "extra rev2 trace\n";
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "HeaderStats.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev2.hpp"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <string>
+
+static double as_double(sedaman::Trace::Header::Value v)
+{
+    return std::holds_alternative<int64_t>(v) ? std::get<int64_t>(v)
+                                              : std::get<double>(v);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    try
+    {
+        std::vector<sedaman::HeaderStats::Field> stats =
+            sedaman::HeaderStats::compute(argv[1],
+                                          sedaman::CommonSEGY::default_trace_header,
+                                          16, 3);
+        std::vector<sedaman::Trace::Header> hdrs;
+        sedaman::ISEGY segy(argv[1]);
+        while (segy.has_trace())
+            hdrs.push_back(segy.read_header());
+        for (auto &f : stats)
+        {
+            std::vector<double> vals;
+            for (auto &h : hdrs)
+                vals.push_back(as_double(*h.get(f.name)));
+            uint64_t nonzero = std::count_if(vals.begin(), vals.end(),
+                                             [](double v) { return v; });
+            double distinct = std::set<double>(vals.begin(), vals.end()).size();
+            if (f.count != vals.size() || f.nonzero != nonzero ||
+                f.min != *std::min_element(vals.begin(), vals.end()) ||
+                f.max != *std::max_element(vals.begin(), vals.end()) ||
+                std::abs(f.distinct - distinct) > std::max(1.0, distinct / 10) ||
+                f.histogram.size() > 16 ||
+                std::accumulate(f.histogram.begin(), f.histogram.end(),
+                                uint64_t(0)) != vals.size() ||
+                f.bin_start > f.min ||
+                f.bin_start + f.bin_width * f.histogram.size() <= f.max)
+            {
+                std::cerr << "wrong statistics of " << f.name << '\n';
+                return 1;
+            }
+        }
+        // second call is served from cache
+        std::vector<sedaman::HeaderStats::Field> cached =
+            sedaman::HeaderStats::compute(argv[1],
+                                          sedaman::CommonSEGY::default_trace_header,
+                                          16, 3);
+        if (cached.size() != stats.size() ||
+            cached.back().histogram != stats.back().histogram)
+        {
+            std::cerr << "wrong cached statistics\n";
+            return 1;
+        }
+        // infinite values are counted but not binned or averaged
+        std::string inf_name = std::string(argv[2]) + "_inf.sgy";
+        sedaman::CommonSEGY::BinaryHeader bh = {};
+        bh.format_code = 5;
+        bh.samp_int = 2000;
+        bh.samp_per_tr = 4;
+        bh.fixed_tr_length = 1;
+        bh.SEGY_rev_major_ver = 2;
+        bh.max_num_add_tr_headers = 1;
+        {
+            sedaman::OSEGYRev2 out(inf_name, {}, bh);
+            double const inf = std::numeric_limits<double>::infinity();
+            for (int i = 0; i < 10; ++i)
+            {
+                double elev = i % 3 ? i * 1.5 : (i % 2 ? -inf : inf);
+                sedaman::Trace t({{"TRC_SEQ_SGY", i}, {"R_ELEV", elev},
+                                  {"SAMP_NUM", 4}, {"SAMP_INT", 2000}},
+                                 std::vector<double>(4));
+                out.write_trace(t);
+            }
+        }
+        std::vector<sedaman::HeaderStats::Field> inf_stats =
+            sedaman::HeaderStats::compute(inf_name,
+                                          sedaman::CommonSEGY::default_trace_header,
+                                          16, 2);
+        auto elev = std::find_if(inf_stats.begin(), inf_stats.end(),
+                                 [](sedaman::HeaderStats::Field const &f)
+                                 { return f.name == "R_ELEV"; });
+        if (elev == inf_stats.end() || elev->count != 10 ||
+            elev->min != 1.5 || elev->max != 12 || elev->mean != 6.75 ||
+            std::accumulate(elev->histogram.begin(), elev->histogram.end(),
+                            uint64_t(0)) != 6)
+        {
+            std::cerr << "wrong statistics of infinite values\n";
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
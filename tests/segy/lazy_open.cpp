@@ -0,0 +1,91 @@
+#include "ISEGY.hpp"
+#include "OSEGYRev2.hpp"
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+        return 1;
+    std::string name = std::string(argv[1]) + ".sgy";
+    std::string cut_name = std::string(argv[1]) + "_cut.sgy";
+    int const traces = 6;
+    std::string end_stanza = "((SEG: EndText))";
+    end_stanza.resize(sedaman::CommonSEGY::TEXT_HEADER_SIZE, ' ');
+    try
+    {
+        sedaman::CommonSEGY::BinaryHeader bh = {};
+        bh.format_code = 5;
+        bh.samp_int = 2000;
+        bh.samp_per_tr = 4;
+        bh.SEGY_rev_major_ver = 2;
+        bh.num_of_tr_in_file = traces;
+        bh.num_of_trailer_stanza = -1;
+        {
+            std::string stanza(sedaman::CommonSEGY::TEXT_HEADER_SIZE, 'T');
+            sedaman::OSEGYRev2 out(name, {}, bh, {stanza, end_stanza});
+            for (int i = 0; i < traces; ++i)
+            {
+                sedaman::Trace t({{"TRC_SEQ_SGY", i}, {"SAMP_NUM", i + 1},
+                                  {"SAMP_INT", 2000}},
+                                 std::vector<double>(i + 1, i));
+                out.write_trace(t);
+            }
+        }
+        sedaman::ISEGY sgy(name);
+        int n = 0;
+        for (; sgy.has_trace(); ++n)
+        {
+            sedaman::Trace t = sgy.read_trace();
+            if (t.samples().size() != static_cast<size_t>(n + 1) ||
+                t.samples().back() != n)
+            {
+                std::cerr << "wrong trace " << n << '\n';
+                return 1;
+            }
+        }
+        if (n != traces || sgy.trailer_stanzas().size() != 2 ||
+            sgy.trailer_stanzas()[1] != end_stanza)
+        {
+            std::cerr << "wrong trailer\n";
+            return 1;
+        }
+        sedaman::ISEGY idx(name);
+        if (idx.traces_count() != traces ||
+            idx.trailer_stanzas().size() != 2)
+        {
+            std::cerr << "wrong index\n";
+            return 1;
+        }
+        // without trailer file could be opened and read up to its end
+        uint64_t size = std::filesystem::file_size(name);
+        std::filesystem::copy_file(
+            name, cut_name, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(
+            cut_name, size - 2 * sedaman::CommonSEGY::TEXT_HEADER_SIZE);
+        sedaman::ISEGY cut(cut_name);
+        if (cut.read_trace().samples().size() != 1)
+        {
+            std::cerr << "wrong first trace\n";
+            return 1;
+        }
+        try
+        {
+            while (cut.has_trace())
+                cut.read_trace();
+            std::cerr << "missing trailer is not detected\n";
+            return 1;
+        }
+        catch (std::exception &)
+        {
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "ISEGY3D.hpp"
+#include "OSEGYRev1.hpp"
+#include <exception>
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+        return 1;
+    int const samp_num = 64;
+    try
+    {
+        sedaman::CommonSEGY::BinaryHeader bh = {};
+        bh.format_code = 1;
+        bh.samp_int = 4000;
+        bh.samp_per_tr = samp_num;
+        bh.fixed_tr_length = 1;
+        bh.SEGY_rev_major_ver = 1;
+        {
+            sedaman::OSEGYRev1 out(argv[1], {}, bh);
+            // crossline is the slow axis in file
+            for (int64_t xl = 1; xl <= 7; ++xl)
+                for (int64_t il = 1; il <= 5; ++il)
+                {
+                    if (il == 2 && xl == 3)
+                        continue;
+                    std::vector<double> samples(samp_num);
+                    for (int s = 0; s < samp_num; ++s)
+                        samples[s] = il * 1000 + xl * 10 + s % 10;
+                    sedaman::Trace t({{"INLINE", il}, {"XLINE", xl},
+                                      {"TRACE_ID", il == 4 && xl == 5 ? 2 : 1},
+                                      {"SAMP_NUM", samp_num},
+                                      {"SAMP_INT", 4000}},
+                                     samples);
+                    out.write_trace(t);
+                }
+        }
+        sedaman::ISEGY3D in(argv[1]);
+        sedaman::ISEGY3D::Cube cube = in.read_cube(3);
+        if (cube.samples.size() != 5 * 7 * samp_num || cube.mask.size() != 35)
+        {
+            std::cerr << "wrong cube size\n";
+            return 1;
+        }
+        for (int64_t il = 1; il <= 5; ++il)
+            for (int64_t xl = 1; xl <= 7; ++xl)
+            {
+                uint64_t node = (il - 1) * 7 + xl - 1;
+                bool live = !(il == 2 && xl == 3) && !(il == 4 && xl == 5);
+                if (cube.mask[node] != live)
+                {
+                    std::cerr << "wrong mask\n";
+                    return 1;
+                }
+                for (int s = 0; s < samp_num; ++s)
+                {
+                    float ref = live ? il * 1000 + xl * 10 + s % 10 : 0;
+                    if (cube.samples[node * samp_num + s] != ref)
+                    {
+                        std::cerr << "wrong sample\n";
+                        return 1;
+                    }
+                }
+            }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// traces are written one by one and in batches
+static void write_all(sedaman::OSEGY &out, std::vector<sedaman::Trace> &traces)
+{
+    for (size_t i = 0; i < traces.size();)
+    {
+        if (i % 3)
+        {
+            out.write_trace(traces[i++]);
+            continue;
+        }
+        std::vector<sedaman::Trace> batch;
+        for (int k = 0; k < 5 && i < traces.size(); ++k)
+            batch.push_back(traces[i++]);
+        out.write_traces(batch);
+    }
+}
+
+static bool same(std::string const &a, std::string const &b)
+{
+    if (content(a) != content(b))
+    {
+        std::cerr << b << " differs from " << a << '\n';
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        sedaman::ISEGY in(argv[1]);
+        std::vector<sedaman::Trace> traces;
+        while (in.has_trace())
+            traces.push_back(in.read_trace());
+        uint64_t const num = traces.size();
+        // too small reservation grows, too big one is cut off
+        for (uint64_t reserve : {uint64_t(10), num, uint64_t(1000)})
+        {
+            std::string name = prefix + std::to_string(reserve) + ".sgy";
+            {
+                sedaman::OSEGYRev1 out(name, in.text_headers(),
+                                       in.binary_header());
+                out.reserve_traces(reserve);
+                write_all(out, traces);
+            }
+            if (!same(argv[1], name))
+                return 1;
+        }
+        // traces are put in place by several threads in reverse order
+        {
+            sedaman::OSEGYRev1 out(prefix + "par1.sgy", in.text_headers(),
+                                   in.binary_header());
+            out.reserve_traces(num - 7);
+            std::vector<std::thread> thrs;
+            for (int t = 0; t < 4; ++t)
+                thrs.emplace_back([&out, &traces, num, t] {
+                    for (int64_t i = num - 1 - t; i >= 0; i -= 4)
+                        out.write_trace_at(i, traces[i]);
+                });
+            for (auto &t : thrs)
+                t.join();
+        }
+        if (!same(argv[1], prefix + "par1.sgy"))
+            return 1;
+        // trailer stanza is written after mapped traces
+        sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+        bh.SEGY_rev_major_ver = 2;
+        std::vector<std::string> stanzas = {
+            std::string(sedaman::CommonSEGY::TEXT_HEADER_SIZE, 'T')};
+        {
+            sedaman::OSEGYRev2 out(prefix + "ref2.sgy", in.text_headers(), bh,
+                                   stanzas);
+            for (sedaman::Trace &t : traces)
+                out.write_trace(t);
+        }
+        {
+            sedaman::OSEGYRev2 out(prefix + "map2.sgy", in.text_headers(), bh,
+                                   stanzas);
+            out.reserve_traces(10);
+            write_all(out, traces);
+        }
+        if (!same(prefix + "ref2.sgy", prefix + "map2.sgy"))
+            return 1;
+        // trace longer than reserved place is refused
+        sedaman::OSEGYRev1 out(prefix + "long.sgy", in.text_headers(),
+                               in.binary_header());
+        out.reserve_traces(num);
+        sedaman::Trace::Header hdr = traces[0].header();
+        hdr.set("SAMP_NUM", static_cast<int64_t>(traces[0].samples().size() +
+                                                 1));
+        sedaman::Trace t(hdr,
+                         std::vector<double>(traces[0].samples().size() + 1));
+        try
+        {
+            out.write_trace_at(0, t);
+            std::cerr << "too long trace is written\n";
+            return 1;
+        }
+        catch (sedaman::Exception &)
+        {
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
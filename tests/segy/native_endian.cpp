@@ -0,0 +1,109 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev2.hpp"
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// writes traces of sample in given format and byte order
+static bool check(std::string const &sample, std::string const &name,
+                  int16_t format, int32_t endianness)
+{
+    std::vector<sedaman::Trace> traces;
+    {
+        sedaman::ISEGY ref(sample);
+        sedaman::CommonSEGY::BinaryHeader bh = ref.binary_header();
+        bh.format_code = format;
+        bh.SEGY_rev_major_ver = 2;
+        bh.endianness = endianness;
+        sedaman::OSEGYRev2 out(name, ref.text_headers(), bh);
+        while (ref.has_trace())
+        {
+            traces.push_back(ref.read_trace());
+            out.write_trace(traces.back());
+        }
+    }
+    sedaman::ISEGY in(name);
+    if (in.binary_header().endianness != endianness)
+    {
+        std::cerr << name << " wrong endianness\n";
+        return false;
+    }
+    if (endianness == sedaman::CommonSEGY::NATIVE_ENDIANNESS)
+    {
+        // samples are stored in host order as they are
+        std::ifstream fl(name, std::ios::binary);
+        std::vector<char> raw(format == 5 ? 4 : 8);
+        fl.seekg(static_cast<std::streamoff>(in.trace_position(1)) +
+                 sedaman::CommonSEGY::TR_HEADER_SIZE + raw.size());
+        fl.read(raw.data(), raw.size());
+        double expected = traces[1].samples()[1];
+        float f = expected;
+        if (std::memcmp(raw.data(), format == 5 ? static_cast<void *>(&f)
+                                                : static_cast<void *>(&expected),
+                        raw.size()))
+        {
+            std::cerr << name << " samples are not in host order\n";
+            return false;
+        }
+    }
+    for (sedaman::Trace &a : traces)
+    {
+        sedaman::Trace b = in.read_trace();
+        if (a.samples() != b.samples())
+        {
+            std::cerr << name << " wrong samples\n";
+            return false;
+        }
+        for (auto &k : a.header().keys())
+            if (*a.header().get(k) != *b.header().get(k))
+            {
+                std::cerr << name << " wrong " << k << '\n';
+                return false;
+            }
+    }
+    return !in.has_trace();
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        if (!check(argv[1], prefix + "float.sgy", 5,
+                   sedaman::CommonSEGY::NATIVE_ENDIANNESS) ||
+            !check(argv[1], prefix + "double.sgy", 6,
+                   sedaman::CommonSEGY::NATIVE_ENDIANNESS) ||
+            !check(argv[1], prefix + "swapped.sgy", 5, 0x04030201) ||
+            !check(argv[1], prefix + "legacy.sgy", 5, 0))
+            return 1;
+        // big endian traces are the same as in sample, only binary header
+        // differs
+        std::string a = content(argv[1]), b = content(prefix + "legacy.sgy");
+        size_t const first = sedaman::CommonSEGY::TEXT_HEADER_SIZE +
+                             sedaman::CommonSEGY::BIN_HEADER_SIZE;
+        if (a.compare(first, std::string::npos, b, first) != 0)
+        {
+            std::cerr << "big endian traces differ from sample\n";
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
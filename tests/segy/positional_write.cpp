@@ -0,0 +1,98 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// every thread writes its own traces backward
+static void write_parallel(sedaman::OSEGY &out,
+                           std::vector<sedaman::Trace> const &traces)
+{
+    std::vector<std::thread> thrs;
+    int num = traces.size();
+    for (int t = 0; t < 4; ++t)
+        thrs.emplace_back([&out, &traces, num, t] {
+            for (int i = num - 1 - t; i >= 0; i -= 4)
+                out.write_trace_at(i, traces[i]);
+        });
+    for (auto &t : thrs)
+        t.join();
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        sedaman::ISEGY in(argv[1]);
+        std::vector<sedaman::Trace> traces;
+        while (in.has_trace())
+            traces.push_back(in.read_trace());
+        sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+        {
+            sedaman::OSEGYRev1 par(prefix + "par.sgy", in.text_headers(), bh);
+            write_parallel(par, traces);
+        }
+        if (content(argv[1]) != content(prefix + "par.sgy"))
+        {
+            std::cerr << "parallel output differs from original file\n";
+            return 1;
+        }
+        // number of traces is set in binary header of revision 2
+        bh.SEGY_rev_major_ver = 2;
+        {
+            sedaman::OSEGYRev2 par(prefix + "par2.sgy", in.text_headers(),
+                                   bh);
+            write_parallel(par, traces);
+        }
+        sedaman::ISEGY par2(prefix + "par2.sgy");
+        if (par2.binary_header().num_of_tr_in_file != traces.size() ||
+            par2.traces_count() != traces.size())
+        {
+            std::cerr << "wrong number of traces\n";
+            return 1;
+        }
+        for (sedaman::Trace &ref : traces)
+        {
+            sedaman::Trace t = par2.read_trace();
+            if (*t.header().get("TRC_SEQ_SGY") !=
+                    *ref.header().get("TRC_SEQ_SGY") ||
+                t.samples() != ref.samples())
+            {
+                std::cerr << "wrong trace in revision 2 file\n";
+                return 1;
+            }
+        }
+        // without samples number in binary header offsets are unknown
+        sedaman::OSEGYRev1 var(prefix + "var.sgy");
+        try
+        {
+            var.write_trace_at(0, traces[0]);
+            std::cerr << "variable length is not detected\n";
+            return 1;
+        }
+        catch (sedaman::Exception &)
+        {
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+
+static double amplitude(int i) { return std::pow(10.0, i % 9 - 4); }
+
+// traces of sample scaled to amplitudes of different order
+static std::vector<sedaman::Trace> read_traces(std::string const &name)
+{
+    sedaman::ISEGY in(name);
+    std::vector<sedaman::Trace> traces;
+    for (int i = 0; in.has_trace(); ++i)
+    {
+        sedaman::Trace t = in.read_trace();
+        std::vector<double> smpls = t.samples();
+        for (double &v : smpls)
+            v *= amplitude(i);
+        traces.push_back(sedaman::Trace(t.header(), smpls));
+    }
+    return traces;
+}
+
+static bool check(std::string const &name,
+                  std::vector<sedaman::Trace> &traces, double range,
+                  bool per_file)
+{
+    sedaman::ISEGY in(name);
+    int file_weight = 0;
+    for (size_t i = 0; i < traces.size(); ++i)
+    {
+        sedaman::Trace t = in.read_trace();
+        int weight = std::get<int64_t>(*t.header().get("TRACE_WEIGHT"));
+        if (per_file && i && weight != file_weight)
+        {
+            std::cerr << name << " weight changes at trace " << i << '\n';
+            return false;
+        }
+        file_weight = weight;
+        std::vector<double> const &orig = traces[i].samples();
+        double max = 0;
+        for (size_t k = 0; k < orig.size(); ++k)
+        {
+            double v = t.samples()[k];
+            max = std::max(max, std::abs(v));
+            // stored values are integer
+            if (v != std::round(v) || v > range || v < -range - 1 ||
+                std::abs(std::ldexp(v, -weight) - orig[k]) >
+                    std::ldexp(0.5, -weight))
+            {
+                std::cerr << name << " wrong sample " << k << " of trace "
+                          << i << '\n';
+                return false;
+            }
+        }
+        // range of format is used
+        if (max < range / 4)
+        {
+            std::cerr << name << " range is not used by trace " << i
+                      << '\n';
+            return false;
+        }
+    }
+    return !in.has_trace();
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        std::vector<sedaman::Trace> traces = read_traces(argv[1]);
+        int const num = traces.size();
+        sedaman::ISEGY in(argv[1]);
+        sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+        bh.format_code = 3;
+        {
+            sedaman::OSEGYRev1 out(prefix + "i16.sgy", in.text_headers(), bh);
+            out.set_quantization(sedaman::OSEGY::Quantization::trace);
+            for (sedaman::Trace &t : traces)
+                out.write_trace(t);
+        }
+        if (!check(prefix + "i16.sgy", traces, INT16_MAX, false))
+            return 1;
+        bh.format_code = 8;
+        bh.SEGY_rev_major_ver = 2;
+        {
+            sedaman::OSEGYRev2 out(prefix + "i8.sgy", in.text_headers(), bh);
+            out.set_quantization(sedaman::OSEGY::Quantization::trace);
+            for (int i = num - 1; i >= 0; --i)
+                out.write_trace_at(i, traces[i]);
+        }
+        if (!check(prefix + "i8.sgy", traces, INT8_MAX, false))
+            return 1;
+        // the same weight for all traces, samples of loud traces are clipped
+        {
+            sedaman::OSEGYRev2 out(prefix + "file.sgy", in.text_headers(),
+                                   bh);
+            out.set_quantization(sedaman::OSEGY::Quantization::file);
+            std::vector<sedaman::Trace> batch;
+            batch.push_back(sedaman::Trace(
+                traces[0].header(),
+                std::vector<double>(traces[0].samples().size())));
+            batch.push_back(traces[4]);
+            batch.push_back(traces[5]);
+            out.write_traces(batch);
+        }
+        sedaman::ISEGY file(prefix + "file.sgy");
+        file.read_trace();
+        sedaman::Trace t = file.read_trace();
+        int weight = std::get<int64_t>(*t.header().get("TRACE_WEIGHT"));
+        t = file.read_trace();
+        if (weight != std::get<int64_t>(*t.header().get("TRACE_WEIGHT")) ||
+            *std::max_element(t.samples().begin(), t.samples().end()) !=
+                INT8_MAX)
+        {
+            std::cerr << "wrong per file quantization\n";
+            return 1;
+        }
+        // sample file itself is in float format
+        try
+        {
+            sedaman::OSEGYRev1 out(prefix + "float.sgy", in.text_headers(),
+                                   in.binary_header());
+            out.set_quantization(sedaman::OSEGY::Quantization::trace);
+        }
+        catch (sedaman::Exception &)
+        {
+            return 0;
+        }
+        std::cerr << "quantization of float format is accepted\n";
+        return 1;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,92 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// copies traces, FFID is changed if edit is set
+static void copy_traces(std::string const &from, std::string const &to,
+                        int16_t format_code, bool edit)
+{
+    sedaman::ISEGY in(from);
+    sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+    bh.format_code = format_code;
+    sedaman::OSEGYRev1 out(to, in.text_headers(), bh);
+    std::vector<char> raw;
+    while (in.has_trace())
+    {
+        sedaman::Trace::Header hdr = in.read_raw_trace(raw);
+        if (edit)
+            hdr.set("FFID", std::get<int64_t>(*hdr.get("TRC_SEQ_SGY")) / 5);
+        out.write_raw_trace(std::move(hdr), raw,
+                            in.binary_header().format_code,
+                            in.binary_header().endianness);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        // unchanged traces in same format give sample file back
+        copy_traces(argv[1], prefix + "same.sgy", 1, false);
+        if (content(argv[1]) != content(prefix + "same.sgy"))
+        {
+            std::cerr << "raw copy differs from sample\n";
+            return 1;
+        }
+        // same format is copied as is, other one is converted
+        copy_traces(argv[1], prefix + "raw.sgy", 1, true);
+        copy_traces(argv[1], prefix + "conv.sgy", 5, true);
+        sedaman::ISEGY src(argv[1]);
+        sedaman::ISEGY raw(prefix + "raw.sgy");
+        sedaman::ISEGY conv(prefix + "conv.sgy");
+        std::vector<char> src_bytes, raw_bytes;
+        uint64_t num = src.traces_count();
+        for (uint64_t i = 0; i < num; ++i)
+        {
+            sedaman::Trace::Header ref_hdr = src.read_raw_trace(src_bytes);
+            sedaman::Trace::Header hdr = raw.read_raw_trace(raw_bytes);
+            sedaman::Trace t = conv.read_trace();
+            int64_t ffid = std::get<int64_t>(*ref_hdr.get("TRC_SEQ_SGY")) / 5;
+            if (src_bytes != raw_bytes ||
+                std::get<int64_t>(*hdr.get("FFID")) != ffid ||
+                std::get<int64_t>(*t.header().get("FFID")) != ffid)
+            {
+                std::cerr << "wrong raw copy of trace " << i << '\n';
+                return 1;
+            }
+            src.seek_trace(i);
+            sedaman::Trace ref = src.read_trace();
+            if (ref.samples() != t.samples())
+            {
+                std::cerr << "wrong conversion of trace " << i << '\n';
+                return 1;
+            }
+        }
+        if (raw.has_trace() || conv.has_trace())
+        {
+            std::cerr << "too many traces\n";
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "OSEGYRev1.hpp"
+#include "SpatialIndex.hpp"
+#include <exception>
+#include <iostream>
+
+// traces in pseudo random order with coordinates in tenths of meter
+static double coord(int64_t i, int k) { return (i * (k ? 37 : 53)) % 101; }
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+        return 1;
+    int const trc_num = 500;
+    try
+    {
+        sedaman::CommonSEGY::BinaryHeader bh = {};
+        bh.format_code = 5;
+        bh.samp_int = 2000;
+        bh.samp_per_tr = 8;
+        bh.fixed_tr_length = 1;
+        bh.SEGY_rev_major_ver = 1;
+        {
+            sedaman::OSEGYRev1 out(argv[1], {}, bh);
+            for (int64_t i = 0; i < trc_num; ++i)
+            {
+                sedaman::Trace t({{"CDP_X", static_cast<int64_t>(coord(i, 0) * 10)},
+                                  {"CDP_Y", static_cast<int64_t>(coord(i, 1) * 10)},
+                                  {"COORD_SCALAR", -10}, {"ENS_NO", i},
+                                  {"SAMP_NUM", 8}, {"SAMP_INT", 2000}},
+                                 std::vector<double>(8));
+                out.write_trace(t);
+            }
+        }
+        sedaman::ISEGY in(argv[1]);
+        sedaman::SpatialIndex idx(in, "CDP_X", "CDP_Y", "COORD_SCALAR", 3);
+        if (idx.size() != trc_num || idx.coordinates(7).first != coord(7, 0))
+        {
+            std::cerr << "wrong index\n";
+            return 1;
+        }
+        std::vector<uint64_t> ref;
+        for (int64_t i = 0; i < trc_num; ++i)
+            if (coord(i, 0) >= 20 && coord(i, 0) <= 45 && coord(i, 1) >= 10 &&
+                coord(i, 1) <= 70)
+                ref.push_back(i);
+        if (idx.query_bbox(20, 10, 45, 70) != ref)
+        {
+            std::cerr << "wrong bbox query\n";
+            return 1;
+        }
+        ref.clear();
+        for (int64_t i = 0; i < trc_num; ++i)
+        {
+            double dx = coord(i, 0) - 50, dy = coord(i, 1) - 40;
+            if (dx * dx + dy * dy <= 30 * 30)
+                ref.push_back(i);
+        }
+        if (idx.query_radius(50, 40, 30) != ref)
+        {
+            std::cerr << "wrong radius query\n";
+            return 1;
+        }
+        // triangle below diagonal, no point lies on its border
+        ref.clear();
+        for (int64_t i = 0; i < trc_num; ++i)
+            if (coord(i, 1) < coord(i, 0) && coord(i, 0) < 90 &&
+                coord(i, 1) > 10)
+                ref.push_back(i);
+        std::vector<uint64_t> res =
+            idx.query_polygon({{11, 10.5}, {89.5, 10.5}, {89.5, 89}});
+        if (res.empty() || res != ref)
+        {
+            std::cerr << "wrong polygon query\n";
+            return 1;
+        }
+        in.seek_trace(res.front());
+        sedaman::Trace t = in.read_trace();
+        if (std::get<int64_t>(*t.header().get("ENS_NO")) !=
+            static_cast<int64_t>(res.front()))
+        {
+            std::cerr << "wrong trace after seek\n";
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include "SEGYSplitter.hpp"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+static std::string output_name(std::string const &prefix,
+                               sedaman::Trace::Header::Value const &v)
+{
+    return prefix + "_" + std::to_string(std::get<int64_t>(v)) + ".sgy";
+}
+
+// channels are interleaved, so outputs grow together and writers are
+// reopened for appending
+static bool check(std::string const &src, std::string const &prefix)
+{
+    sedaman::SEGYSplitter splitter(
+        src, "CHAN",
+        [&prefix](sedaman::Trace::Header::Value const &v) {
+            return output_name(prefix, v);
+        },
+        2, 5000);
+    std::map<std::string, uint64_t> counts = splitter.split();
+    sedaman::ISEGY ref(src);
+    std::map<std::string, std::vector<sedaman::Trace>> expected;
+    while (ref.has_trace())
+    {
+        sedaman::Trace t = ref.read_trace();
+        expected[output_name(prefix, *t.header().get("CHAN"))].push_back(t);
+    }
+    if (counts.size() != expected.size())
+    {
+        std::cerr << prefix << " wrong number of outputs\n";
+        return false;
+    }
+    for (auto &[name, traces] : expected)
+    {
+        sedaman::ISEGY in(name);
+        if (counts[name] != traces.size() ||
+            (ref.binary_header().SEGY_rev_major_ver > 1 &&
+             in.binary_header().num_of_tr_in_file != traces.size()))
+        {
+            std::cerr << name << " wrong number of traces\n";
+            return false;
+        }
+        for (sedaman::Trace &a : traces)
+        {
+            sedaman::Trace b = in.read_trace();
+            if (a.samples() != b.samples() ||
+                *a.header().get("TRC_SEQ_SGY") !=
+                    *b.header().get("TRC_SEQ_SGY"))
+            {
+                std::cerr << name << " wrong trace\n";
+                return false;
+            }
+        }
+        if (in.has_trace())
+        {
+            std::cerr << name << " too many traces\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        // all traces of sample have the same FFID
+        sedaman::SEGYSplitter whole(
+            argv[1], "FFID",
+            [&prefix](sedaman::Trace::Header::Value const &v) {
+                return output_name(prefix + "ffid", v);
+            },
+            2, 5000);
+        whole.split();
+        if (content(argv[1]) != content(prefix + "ffid_0.sgy"))
+        {
+            std::cerr << "single output differs from sample\n";
+            return 1;
+        }
+        // same traces in revision 2 file and in file with variable trace
+        // length, every trace is shortened a bit
+        sedaman::ISEGY in(argv[1]);
+        sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+        bh.SEGY_rev_major_ver = 2;
+        bh.num_of_tr_in_file = in.traces_count();
+        {
+            sedaman::OSEGYRev2 fix(prefix + "fix.sgy", in.text_headers(), bh);
+            bh = in.binary_header();
+            bh.fixed_tr_length = 0;
+            sedaman::OSEGYRev1 var(prefix + "var.sgy", in.text_headers(), bh);
+            for (uint64_t i = 0; in.has_trace(); ++i)
+            {
+                sedaman::Trace t = in.read_trace();
+                fix.write_trace(t);
+                std::vector<double> smpls = t.samples();
+                smpls.resize(smpls.size() - i % 7);
+                sedaman::Trace::Header hdr = t.header();
+                hdr.set("SAMP_NUM", static_cast<int64_t>(smpls.size()));
+                sedaman::Trace v(hdr, smpls);
+                var.write_trace(v);
+            }
+        }
+        if (!check(argv[1], prefix + "chan") ||
+            !check(prefix + "fix.sgy", prefix + "fix") ||
+            !check(prefix + "var.sgy", prefix + "var"))
+            return 1;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
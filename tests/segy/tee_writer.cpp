@@ -0,0 +1,133 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include "OSEGYRev2.hpp"
+#include "SEGYTee.hpp"
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// traces are written one by one and in batches
+static void write_all(std::function<void(sedaman::Trace &)> one,
+                      std::function<void(std::vector<sedaman::Trace> &)> many,
+                      std::vector<sedaman::Trace> const &traces)
+{
+    for (size_t i = 0; i < traces.size();)
+    {
+        if (i % 4 == 1)
+        {
+            sedaman::Trace t = traces[i++];
+            one(t);
+            continue;
+        }
+        std::vector<sedaman::Trace> batch;
+        for (int k = 0; k < 6 && i < traces.size(); ++k)
+            batch.push_back(traces[i++]);
+        many(batch);
+    }
+}
+
+static std::unique_ptr<sedaman::OSEGY> make_writer(std::string const &name,
+                                                   sedaman::ISEGY &in,
+                                                   int16_t format, int rev,
+                                                   bool quantize)
+{
+    sedaman::CommonSEGY::BinaryHeader bh = in.binary_header();
+    bh.format_code = format;
+    bh.SEGY_rev_major_ver = rev;
+    std::unique_ptr<sedaman::OSEGY> result;
+    if (rev > 1)
+        result = std::make_unique<sedaman::OSEGYRev2>(name, in.text_headers(),
+                                                      bh);
+    else
+        result = std::make_unique<sedaman::OSEGYRev1>(name, in.text_headers(),
+                                                      bh);
+    if (quantize)
+        result->set_quantization(sedaman::OSEGY::Quantization::trace);
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    struct Output
+    {
+        std::string name;
+        int16_t format;
+        int rev;
+        bool quantize;
+        bool reserve;
+    };
+    std::vector<Output> outputs = {
+        {"full", 5, 2, false, true},  {"copy", 5, 2, false, true},
+        {"preview", 3, 2, true, false}, {"rev1", 5, 1, false, false},
+        {"copy1", 5, 1, false, true},   {"preview8", 8, 2, true, true}};
+    try
+    {
+        sedaman::ISEGY in(argv[1]);
+        std::vector<sedaman::Trace> traces;
+        while (in.has_trace())
+            traces.push_back(in.read_trace());
+        uint64_t const num = traces.size();
+        std::vector<std::unique_ptr<sedaman::OSEGY>> writers;
+        for (Output const &o : outputs)
+        {
+            writers.push_back(make_writer(prefix + o.name + ".sgy", in,
+                                          o.format, o.rev, o.quantize));
+            if (o.reserve)
+                writers.back()->reserve_traces(num / 2);
+        }
+        {
+            sedaman::SEGYTee tee(move(writers));
+            write_all([&tee](sedaman::Trace &t) { tee.write_trace(t); },
+                      [&tee](std::vector<sedaman::Trace> &t) {
+                          tee.write_traces(t);
+                      },
+                      traces);
+        }
+        // outputs in format and revision of sample give it back
+        if (content(argv[1]) != content(prefix + "rev1.sgy") ||
+            content(argv[1]) != content(prefix + "copy1.sgy"))
+        {
+            std::cerr << "output differs from sample\n";
+            return 1;
+        }
+        for (Output const &o : outputs)
+        {
+            std::string ref = prefix + o.name + "_ref.sgy";
+            {
+                std::unique_ptr<sedaman::OSEGY> out =
+                    make_writer(ref, in, o.format, o.rev, o.quantize);
+                write_all([&out](sedaman::Trace &t) { out->write_trace(t); },
+                          [&out](std::vector<sedaman::Trace> &t) {
+                              out->write_traces(t);
+                          },
+                          traces);
+            }
+            if (content(ref) != content(prefix + o.name + ".sgy"))
+            {
+                std::cerr << o.name << " differs from separate writer\n";
+                return 1;
+            }
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "ISEGY3D.hpp"
+#include "OSEGYRev1.hpp"
+#include <exception>
+#include <iostream>
+
+// sample value which could be checked after reading
+static double value(int64_t il, int64_t xl, int s)
+{
+    return il * 10000 + xl * 10 + s;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+        return 1;
+    int const samp_num = 50;
+    try
+    {
+        sedaman::CommonSEGY::BinaryHeader bh = {};
+        bh.format_code = 5;
+        bh.samp_int = 2000;
+        bh.samp_per_tr = samp_num;
+        bh.fixed_tr_length = 1;
+        bh.SEGY_rev_major_ver = 1;
+        {
+            sedaman::OSEGYRev1 out(argv[1], {}, bh);
+            for (int64_t il = 10; il <= 20; il += 2)
+                for (int64_t xl = 100; xl <= 130; xl += 3)
+                {
+                    if (il == 14 && xl == 109)
+                        continue;
+                    std::vector<double> samples(samp_num);
+                    for (int s = 0; s < samp_num; ++s)
+                        samples[s] = value(il, xl, s);
+                    sedaman::Trace t({{"INLINE", il}, {"XLINE", xl},
+                                      {"SAMP_NUM", samp_num},
+                                      {"SAMP_INT", 2000}},
+                                     samples);
+                    out.write_trace(t);
+                }
+        }
+        sedaman::ISEGY3D in(argv[1]);
+        sedaman::ISEGY3D::Grid const &g = in.grid();
+        if (g.il_first != 10 || g.il_step != 2 || g.il_num != 6 ||
+            g.xl_first != 100 || g.xl_step != 3 || g.xl_num != 11 ||
+            g.missing != 1)
+        {
+            std::cerr << "wrong grid\n";
+            return 1;
+        }
+        if (in.trace_exists(14, 109) || !in.trace_exists(14, 112))
+        {
+            std::cerr << "wrong missing trace\n";
+            return 1;
+        }
+        std::vector<double> il = in.inline_section(14);
+        for (uint64_t x = 0; x < g.xl_num; ++x)
+            for (int s = 0; s < samp_num; ++s)
+            {
+                int64_t xl = 100 + x * 3;
+                double ref = xl == 109 ? 0 : value(14, xl, s);
+                if (il[x * samp_num + s] != ref)
+                {
+                    std::cerr << "wrong inline section\n";
+                    return 1;
+                }
+            }
+        std::vector<double> xl = in.crossline_section(127);
+        for (uint64_t i = 0; i < g.il_num; ++i)
+            for (int s = 0; s < samp_num; ++s)
+                if (xl[i * samp_num + s] != value(10 + i * 2, 127, s))
+                {
+                    std::cerr << "wrong crossline section\n";
+                    return 1;
+                }
+        std::vector<double> ts = in.time_slice(33);
+        for (uint64_t i = 0; i < g.il_num; ++i)
+            for (uint64_t x = 0; x < g.xl_num; ++x)
+            {
+                int64_t il = 10 + i * 2, xl = 100 + x * 3;
+                double ref = il == 14 && xl == 109 ? 0 : value(il, xl, 33);
+                if (ts[i * g.xl_num + x] != ref)
+                {
+                    std::cerr << "wrong time slice\n";
+                    return 1;
+                }
+            }
+        sedaman::Trace t = in.get_trace(20, 130);
+        if (t.samples()[7] != value(20, 130, 7))
+        {
+            std::cerr << "wrong trace\n";
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
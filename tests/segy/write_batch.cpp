@@ -0,0 +1,103 @@
+#include "Exception.hpp"
+#include "ISEGY.hpp"
+#include "OSEGYRev1.hpp"
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+static std::string content(std::string const &name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+}
+
+// writes traces in batches of uneven size, the last one is shorter
+static void write_batches(sedaman::OSEGY &out,
+                          std::vector<sedaman::Trace> const &traces)
+{
+    for (size_t i = 0; i < traces.size(); i += 37)
+    {
+        std::vector<sedaman::Trace> part(
+            traces.begin() + i,
+            traces.begin() + std::min<size_t>(i + 37, traces.size()));
+        out.write_traces(part);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+        return 1;
+    std::string prefix = argv[2];
+    try
+    {
+        sedaman::ISEGY in(argv[1]);
+        std::vector<sedaman::Trace> traces;
+        while (in.has_trace())
+            traces.push_back(in.read_trace());
+        {
+            sedaman::OSEGYRev1 batch(prefix + "batch.sgy", in.text_headers(),
+                                     in.binary_header());
+            write_batches(batch, traces);
+            sedaman::OSEGYRev1 matrix(prefix + "matrix.sgy",
+                                      in.text_headers(), in.binary_header());
+            std::vector<std::unordered_map<std::string,
+                                           sedaman::Trace::Header::Value>>
+                headers;
+            std::vector<double> samples;
+            for (sedaman::Trace &t : traces)
+            {
+                std::unordered_map<std::string, sedaman::Trace::Header::Value>
+                    hdr;
+                for (auto &k : t.header().keys())
+                    hdr[k] = *t.header().get(k);
+                headers.push_back(hdr);
+                samples.insert(samples.end(), t.samples().begin(),
+                               t.samples().end());
+            }
+            matrix.write_traces(headers, samples);
+            try
+            {
+                // nothing of wrong matrix is written
+                samples.pop_back();
+                matrix.write_traces(headers, samples);
+                std::cerr << "wrong matrix is not detected\n";
+                return 1;
+            }
+            catch (sedaman::Exception &)
+            {
+            }
+        }
+        std::string ref = content(argv[1]);
+        if (ref != content(prefix + "batch.sgy") ||
+            ref != content(prefix + "matrix.sgy"))
+        {
+            std::cerr << "batch differs from original file\n";
+            return 1;
+        }
+        // empty binary header is filled from the first trace of batch
+        {
+            sedaman::CommonSEGY::BinaryHeader bh = {};
+            sedaman::OSEGYRev1 one(prefix + "one.sgy", {}, bh);
+            for (sedaman::Trace &t : traces)
+                one.write_trace(t);
+            sedaman::OSEGYRev1 batch(prefix + "empty.sgy", {}, bh);
+            write_batches(batch, traces);
+        }
+        if (content(prefix + "one.sgy") != content(prefix + "empty.sgy"))
+        {
+            std::cerr << "batch differs from single writes\n";
+            return 1;
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}